@@ -0,0 +1,112 @@
+#include "corpus_generator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// слово ранга rank: запись номера в системе счисления из 26 букв, поэтому частые слова короче
+std::string MakeWord(size_t rank) {
+    std::string word;
+    size_t number = rank + 1;
+    while (number > 0) {
+        --number;
+        word += static_cast<char>('a' + number % 26);
+        number /= 26;
+    }
+    return word;
+}
+
+} // namespace
+
+CorpusGenerator::CorpusGenerator(const CorpusOptions& options)
+        : options_(options)
+        , generator_(options.seed) {
+    options_.vocabulary_size = std::max<size_t>(options_.vocabulary_size, options_.stop_word_count + 1);
+    options_.min_document_words = std::max<size_t>(options_.min_document_words, 1);
+    options_.max_document_words = std::max(options_.max_document_words, options_.min_document_words);
+    words_.reserve(options_.vocabulary_size);
+    cumulative_weights_.reserve(options_.vocabulary_size);
+    double weight_sum = 0.0;
+    for (size_t rank = 0; rank < options_.vocabulary_size; ++rank) {
+        words_.push_back(MakeWord(rank));
+        weight_sum += 1.0 / std::pow(static_cast<double>(rank + 1), options_.zipf_exponent);
+        cumulative_weights_.push_back(weight_sum);
+    }
+}
+
+std::string CorpusGenerator::GetStopWords() const {
+    std::string stop_words;
+    for (size_t rank = 0; rank < options_.stop_word_count; ++rank) {
+        stop_words += words_[rank];
+        stop_words += ' ';
+    }
+    return stop_words;
+}
+
+std::vector<GeneratedDocument> CorpusGenerator::GenerateDocuments() {
+    std::vector<GeneratedDocument> documents(options_.document_count);
+    const size_t length_range = options_.max_document_words - options_.min_document_words + 1;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        GeneratedDocument& document = documents[i];
+        document.id = static_cast<int>(i);
+        const size_t word_count = options_.min_document_words + NextIndex(length_range);
+        for (size_t j = 0; j < word_count; ++j) {
+            document.text += words_[NextWordRank()];
+            document.text += ' ';
+        }
+        // статусы распределены неравномерно, как в живом индексе: большая часть документов актуальна
+        const size_t status_roll = NextIndex(10);
+        document.status = status_roll < 7 ? DocumentStatus::ACTUAL
+                          : status_roll < 8 ? DocumentStatus::IRRELEVANT
+                          : status_roll < 9 ? DocumentStatus::BANNED
+                          : DocumentStatus::REMOVED;
+        const size_t rating_count = 1 + NextIndex(5);
+        for (size_t j = 0; j < rating_count; ++j) {
+            document.ratings.push_back(static_cast<int>(NextIndex(21)) - 5);
+        }
+    }
+    return documents;
+}
+
+std::vector<std::string> CorpusGenerator::GenerateQueries(const QueryMixOptions& options) {
+    std::vector<std::string> queries;
+    queries.reserve(options.query_count);
+    for (size_t i = 0; i < options.query_count; ++i) {
+        const double kind_roll = NextUniform();
+        const size_t word_count = kind_roll < options.single_word_share ? 1
+                                  : kind_roll < options.single_word_share + options.long_query_share
+                                    ? options.long_query_words
+                                    : options.short_query_words;
+        std::string query;
+        for (size_t j = 0; j < word_count; ++j) {
+            // первое слово всегда плюс-слово, иначе запрос может оказаться пустым
+            if (j > 0 && NextUniform() < options.minus_word_share) {
+                query += '-';
+            }
+            // запросы не состоят из одних стоп-слов: ранги берутся из остальной части словаря
+            size_t rank = NextWordRank();
+            while (rank < options_.stop_word_count) {
+                rank = NextWordRank();
+            }
+            query += words_[rank];
+            query += ' ';
+        }
+        queries.push_back(std::move(query));
+    }
+    return queries;
+}
+
+double CorpusGenerator::NextUniform() {
+    return static_cast<double>(generator_() >> 11) * 0x1.0p-53;
+}
+
+size_t CorpusGenerator::NextIndex(size_t bound) {
+    return static_cast<size_t>(NextUniform() * bound);
+}
+
+size_t CorpusGenerator::NextWordRank() {
+    const double point = NextUniform() * cumulative_weights_.back();
+    const auto it = std::upper_bound(cumulative_weights_.begin(), cumulative_weights_.end(), point);
+    return std::min<size_t>(it - cumulative_weights_.begin(), cumulative_weights_.size() - 1);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "../document.h"
+
+// параметры синтетического корпуса: слова словаря встречаются с частотами по закону Ципфа
+// (частота слова ранга r пропорциональна 1 / r^zipf_exponent), самые частые из них - стоп-слова
+struct CorpusOptions {
+    uint64_t seed = 42;
+    size_t vocabulary_size = 50000;
+    double zipf_exponent = 1.0;
+    size_t stop_word_count = 20;
+    size_t document_count = 50000;
+    size_t min_document_words = 20;
+    size_t max_document_words = 200;
+};
+
+// состав потока запросов: доли однословных и длинных запросов (остальные - короткие)
+// и вероятность, что слово запроса окажется минус-словом
+struct QueryMixOptions {
+    size_t query_count = 2000;
+    double single_word_share = 0.2;
+    double long_query_share = 0.2;
+    size_t short_query_words = 3;
+    size_t long_query_words = 8;
+    double minus_word_share = 0.1;
+};
+
+struct GeneratedDocument {
+    int id = 0;
+    std::string text;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+};
+
+// детерминированный генератор корпуса и запросов: при одних параметрах и одном seed
+// выдаёт одни и те же документы и запросы
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(const CorpusOptions& options);
+
+    // стоп-слова через пробел, для конструктора SearchServer
+    std::string GetStopWords() const;
+
+    std::vector<GeneratedDocument> GenerateDocuments();
+
+    std::vector<std::string> GenerateQueries(const QueryMixOptions& options);
+
+private:
+    CorpusOptions options_;
+    std::mt19937_64 generator_;
+    std::vector<std::string> words_;
+    // cumulative_weights_[r] - сумма весов слов рангов 0..r
+    std::vector<double> cumulative_weights_;
+
+    // равномерное число из [0, 1); не зависит от реализации распределений стандартной библиотеки
+    double NextUniform();
+    size_t NextIndex(size_t bound);
+    // ранг слова по закону Ципфа
+    size_t NextWordRank();
+};
\ No newline at end of file
@@ -0,0 +1,687 @@
+// нагрузочный замер SearchServer на синтетическом корпусе (corpus_generator.h).
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. benchmark/*.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o search_benchmark
+// Параметры - пары ключ=значение, например: ./search_benchmark documents=200000 zipf=1.1 queries=5000
+// Без SEARCH_SERVER_NO_PROFILING в конце печатаются времена стадий поиска и число документов, подсчитанных
+// и отсечённых обходом MaxScore (search_profiler.h)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <execution>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <tbb/global_control.h>
+#include "../concurrent_search_server.h"
+#include "../index_snapshot.h"
+#include "../log_duration.h"
+#include "../process_queries.h"
+#include "../query_cache.h"
+#include "../request_queue.h"
+#include "../search_profiler.h"
+#include "../search_server.h"
+#include "../segmented_search_server.h"
+#include "../sharded_search_server.h"
+#include "../string_processing.h"
+#include "../top_documents.h"
+#include "corpus_generator.h"
+
+namespace {
+
+// счётчики глобального operator new: число выделений и объём живой памяти кучи
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<int64_t> allocated_bytes{0};
+
+void* Allocate(size_t size) {
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(static_cast<int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+    return pointer;
+}
+
+void Deallocate(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    allocated_bytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+    std::free(pointer);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    return Allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    Deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    Deallocate(pointer);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkOptions {
+    CorpusOptions corpus;
+    QueryMixOptions query_mix;
+    size_t top_k = MAX_RESULT_DOCUMENT_COUNT;
+    // замер стадий: каждый profile_sample_period-й проход стадии
+    uint32_t profile_sample_period = 1;
+    // журнал запросов для кэша: запрос ранга r из пула выбирается с весом 1 / r^query_log_zipf
+    size_t query_log_size = 50000;
+    double query_log_zipf = 1.0;
+    // SegmentedSearchServer: документов в изменяемом сегменте до запечатывания и сегментов в одном слиянии
+    size_t seal_threshold = 2048;
+    size_t merge_factor = SegmentedSearchServer::DEFAULT_MERGE_FACTOR;
+    // временный файл для замера снимка индекса, удаляется после замера
+    std::string snapshot_path = (std::filesystem::temp_directory_path() / "search_benchmark.snapshot").string();
+};
+
+BenchmarkOptions ParseOptions(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        const size_t separator = argument.find('=');
+        if (separator == std::string_view::npos) {
+            throw std::invalid_argument("expected key=value, got " + std::string(argument));
+        }
+        const std::string key(argument.substr(0, separator));
+        const std::string value(argument.substr(separator + 1));
+        if (key == "seed") {
+            options.corpus.seed = std::stoull(value);
+        } else if (key == "documents") {
+            options.corpus.document_count = std::stoul(value);
+        } else if (key == "vocabulary") {
+            options.corpus.vocabulary_size = std::stoul(value);
+        } else if (key == "zipf") {
+            options.corpus.zipf_exponent = std::stod(value);
+        } else if (key == "stop_words") {
+            options.corpus.stop_word_count = std::stoul(value);
+        } else if (key == "min_words") {
+            options.corpus.min_document_words = std::stoul(value);
+        } else if (key == "max_words") {
+            options.corpus.max_document_words = std::stoul(value);
+        } else if (key == "queries") {
+            options.query_mix.query_count = std::stoul(value);
+        } else if (key == "single_word_share") {
+            options.query_mix.single_word_share = std::stod(value);
+        } else if (key == "long_query_share") {
+            options.query_mix.long_query_share = std::stod(value);
+        } else if (key == "short_query_words") {
+            options.query_mix.short_query_words = std::stoul(value);
+        } else if (key == "long_query_words") {
+            options.query_mix.long_query_words = std::stoul(value);
+        } else if (key == "minus_share") {
+            options.query_mix.minus_word_share = std::stod(value);
+        } else if (key == "top_k") {
+            options.top_k = std::stoul(value);
+        } else if (key == "profile_period") {
+            options.profile_sample_period = static_cast<uint32_t>(std::stoul(value));
+        } else if (key == "query_log") {
+            options.query_log_size = std::stoul(value);
+        } else if (key == "query_log_zipf") {
+            options.query_log_zipf = std::stod(value);
+        } else if (key == "seal_threshold") {
+            options.seal_threshold = std::stoul(value);
+        } else if (key == "merge_factor") {
+            options.merge_factor = std::stoul(value);
+        } else if (key == "snapshot") {
+            options.snapshot_path = value;
+        } else {
+            throw std::invalid_argument("unknown option " + key);
+        }
+    }
+    return options;
+}
+
+double ToMicroseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+// сортирует latencies и печатает имя замера и перцентили без перевода строки
+void PrintPercentiles(std::string_view name, std::vector<Clock::duration>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](size_t percent) {
+        return ToMicroseconds(latencies[(latencies.size() - 1) * percent / 100]);
+    };
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << " p50 " << std::setw(9) << percentile(50)
+              << " p90 " << std::setw(9) << percentile(90)
+              << " p99 " << std::setw(9) << percentile(99)
+              << " max " << std::setw(9) << ToMicroseconds(latencies.back()) << " us";
+}
+
+// выполняет operation(i) для i из [0, count) после прогревочного прохода и печатает
+// перцентили времени одного вызова, пропускную способность и число выделений памяти на вызов
+template <typename Operation>
+void MeasureLatency(std::string_view name, size_t count, Operation operation) {
+    for (size_t i = 0; i < count; ++i) {
+        operation(i);
+    }
+    std::vector<Clock::duration> latencies(count);
+    const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const Clock::time_point call_start = Clock::now();
+        operation(i);
+        latencies[i] = Clock::now() - call_start;
+    }
+    const Clock::duration total = Clock::now() - start;
+    const uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+    PrintPercentiles(name, latencies);
+    std::cout << std::setprecision(0) << std::setw(10) << count / std::chrono::duration<double>(total).count()
+              << " ops/s" << std::setprecision(2) << std::setw(10) << static_cast<double>(allocations) / count
+              << " allocs/op" << std::endl;
+}
+
+void MeasureIngest(const std::string& stop_words, const std::vector<GeneratedDocument>& documents) {
+    std::cout << "ingest, " << documents.size() << " documents" << std::endl;
+    {
+        // токены входа вместе со стоп-словами: столько слов проходит через разбор
+        uint64_t token_count = 0;
+        for (const GeneratedDocument& document : documents) {
+            token_count += SplitIntoWords(document.text).size();
+        }
+        const SearchServer search_server(stop_words);
+        uint64_t kept_count = 0;
+        const Clock::time_point start = Clock::now();
+        for (const GeneratedDocument& document : documents) {
+            kept_count += search_server.PrepareDocument(document.id, document.text, document.status,
+                                                        document.ratings).word_count;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  PrepareDocument:          " << token_count / seconds / 1e6 << " Mtokens/s ("
+                  << kept_count << " of " << token_count << " tokens are not stop words)" << std::endl;
+    }
+    {
+        const int64_t bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+        const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+        const Clock::time_point start = Clock::now();
+        SearchServer search_server(stop_words);
+        for (const GeneratedDocument& document : documents) {
+            search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+        const int64_t bytes = allocated_bytes.load(std::memory_order_relaxed) - bytes_before;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  AddDocument:              " << documents.size() / seconds << " docs/s, "
+                  << std::setprecision(1) << static_cast<double>(allocations) / documents.size() << " allocs/doc, "
+                  << static_cast<double>(bytes) / documents.size() << " bytes/doc of index" << std::endl;
+    }
+    for (const bool is_parallel : {false, true}) {
+        std::vector<SearchServer::DocumentToAdd> batch;
+        batch.reserve(documents.size());
+        for (const GeneratedDocument& document : documents) {
+            batch.push_back({document.id, document.text, document.status, document.ratings});
+        }
+        const Clock::time_point start = Clock::now();
+        SearchServer search_server(stop_words);
+        if (is_parallel) {
+            search_server.AddDocuments(std::execution::par, batch);
+        } else {
+            search_server.AddDocuments(std::execution::seq, batch);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(0)
+                  << (is_parallel ? "  AddDocuments(par):        " : "  AddDocuments(seq):        ")
+                  << documents.size() / seconds << " docs/s" << std::endl;
+    }
+}
+
+void MeasureQueries(const SearchServer& search_server, const std::vector<GeneratedDocument>& documents,
+                    const std::vector<std::string>& queries, size_t top_k) {
+    std::cout << "queries, " << queries.size() << " per operation" << std::endl;
+    MeasureLatency("FindTopDocuments", queries.size(), [&](size_t i) {
+        search_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+    });
+    MeasureLatency("FindTopDocuments(par)", queries.size(), [&](size_t i) {
+        search_server.FindTopDocuments(std::execution::par, queries[i], DocumentStatus::ACTUAL, top_k);
+    });
+    MeasureLatency("FindTopDocuments(lambda)", queries.size(), [&](size_t i) {
+        search_server.FindTopDocuments(queries[i], [](int document_id, DocumentStatus, int rating) {
+            return document_id % 2 == 0 && rating > 0;
+        }, top_k);
+    });
+    MeasureLatency("MatchDocument", queries.size(), [&](size_t i) {
+        search_server.MatchDocument(queries[i], documents[i * 7919 % documents.size()].id);
+    });
+    MeasureLatency("MatchDocument(seq)", queries.size(), [&](size_t i) {
+        search_server.MatchDocument(std::execution::seq, queries[i], documents[i * 7919 % documents.size()].id);
+    });
+    MeasureLatency("MatchDocument(par)", queries.size(), [&](size_t i) {
+        search_server.MatchDocument(std::execution::par, queries[i], documents[i * 7919 % documents.size()].id);
+    });
+    RequestQueue request_queue(search_server);
+    MeasureLatency("RequestQueue::AddFindRequest", queries.size(), [&](size_t i) {
+        request_queue.AddFindRequest(queries[i]);
+    });
+    RequestQueue uncached_request_queue(search_server, 0);
+    MeasureLatency("RequestQueue (no cache)", queries.size(), [&](size_t i) {
+        uncached_request_queue.AddFindRequest(queries[i]);
+    });
+}
+
+// кэш запросов на журнале, где запросы пула повторяются с частотами по закону Ципфа: доля попаданий,
+// счётчики кэша и среднее время запроса при разной ёмкости; ёмкость 0 - поиск без кэша
+void MeasureQueryCache(const SearchServer& search_server, const std::vector<std::string>& queries, size_t top_k,
+                       size_t log_size, double zipf_exponent, uint64_t seed) {
+    std::vector<double> weights(queries.size());
+    for (size_t rank = 0; rank < queries.size(); ++rank) {
+        weights[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), zipf_exponent);
+    }
+    std::discrete_distribution<size_t> distribution(weights.begin(), weights.end());
+    std::mt19937_64 generator(seed);
+    std::vector<size_t> query_log(log_size);
+    for (size_t& query_index : query_log) {
+        query_index = distribution(generator);
+    }
+    std::cout << "QueryCache, " << log_size << " requests over " << queries.size() << " queries, zipf "
+              << zipf_exponent << std::endl;
+    for (const size_t capacity : {size_t{0}, queries.size() / 100, queries.size() / 10, queries.size() / 2,
+                                  queries.size()}) {
+        QueryCache cache(capacity);
+        const Clock::time_point start = Clock::now();
+        for (const size_t query_index : query_log) {
+            cache.FindTopDocuments(search_server, queries[query_index], DocumentStatus::ACTUAL, top_k);
+        }
+        const double total_us = ToMicroseconds(Clock::now() - start);
+        const uint64_t hit_count = cache.GetHitCount();
+        const uint64_t miss_count = cache.GetMissCount();
+        std::cout << std::fixed << "  capacity " << std::setw(6) << capacity << ": hits " << std::setw(8)
+                  << hit_count << ", misses " << std::setw(8) << miss_count << ", hit rate " << std::setprecision(1)
+                  << std::setw(5) << 100.0 * hit_count / (hit_count + miss_count) << "%, " << std::setw(8)
+                  << total_us / log_size << " us/request" << std::endl;
+    }
+}
+
+// поиск в ConcurrentSearchServer без записи и во время пакетного добавления второй половины корпуса
+// в соседнем потоке: задержки запросов и скорость добавления, пока идёт замер. Выделения памяти
+// на запрос во время добавления включают выделения пишущего потока
+void MeasureConcurrentIngest(const std::string& stop_words, const std::vector<GeneratedDocument>& documents,
+                             const std::vector<std::string>& queries, size_t top_k) {
+    constexpr size_t BATCH_SIZE = 1000;
+    const size_t half = documents.size() / 2;
+    SearchServer search_server(stop_words);
+    for (size_t i = 0; i < half; ++i) {
+        search_server.AddDocument(documents[i].id, documents[i].text, documents[i].status, documents[i].ratings);
+    }
+    ConcurrentSearchServer concurrent_server(std::move(search_server));
+    std::cout << "ConcurrentSearchServer, " << half << " documents, then adding " << documents.size() - half
+              << " in batches of " << BATCH_SIZE << std::endl;
+    const auto find = [&](size_t i) {
+        concurrent_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+    };
+    MeasureLatency("FindTopDocuments(idle)", queries.size(), find);
+
+    std::atomic<bool> is_measuring{true};
+    size_t added_count = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point finish;
+    std::thread writer([&] {
+        for (size_t first = half; first < documents.size() && is_measuring; first += BATCH_SIZE) {
+            std::vector<SearchServer::DocumentToAdd> batch;
+            for (size_t i = first; i < std::min(first + BATCH_SIZE, documents.size()); ++i) {
+                batch.push_back({documents[i].id, documents[i].text, documents[i].status, documents[i].ratings});
+            }
+            concurrent_server.AddDocuments(batch);
+            added_count += batch.size();
+        }
+        finish = Clock::now();
+    });
+    MeasureLatency("FindTopDocuments(ingesting)", queries.size(), find);
+    is_measuring = false;
+    writer.join();
+    std::cout << std::fixed << std::setprecision(0) << "  added " << added_count << " documents, "
+              << added_count / std::chrono::duration<double>(finish - start).count() << " docs/s"
+              << (added_count < documents.size() - half ? " (stopped with the queries)" : "") << std::endl;
+}
+
+// перцентили и число вызовов, измеренных вне MeasureLatency; пустой замер не печатается
+void PrintCalls(std::string_view name, std::vector<Clock::duration>& latencies) {
+    if (latencies.empty()) {
+        return;
+    }
+    PrintPercentiles(name, latencies);
+    std::cout << std::setw(10) << latencies.size() << " calls" << std::endl;
+}
+
+// SegmentedSearchServer: задержка AddDocument при загрузке всего корпуса, отдельно для вставок во время
+// фонового слияния, затем поиск без записи и во время добавления второй половины корпуса в соседнем потоке,
+// отдельно для запросов, начатых во время слияния. Поток слияния делит ядра с вставкой и поиском
+void MeasureSegmentedIngest(const std::string& stop_words, const std::vector<GeneratedDocument>& documents,
+                            const std::vector<std::string>& queries, size_t top_k, size_t seal_threshold,
+                            size_t merge_factor) {
+    std::cout << "SegmentedSearchServer, seal threshold " << seal_threshold << ", merge factor " << merge_factor
+              << std::endl;
+    {
+        SegmentedSearchServer search_server(stop_words, seal_threshold, merge_factor);
+        std::vector<Clock::duration> latencies;
+        std::vector<Clock::duration> merge_latencies;
+        const Clock::time_point start = Clock::now();
+        for (const GeneratedDocument& document : documents) {
+            const bool is_merging = search_server.IsMergeRunning();
+            const Clock::time_point call_start = Clock::now();
+            search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+            (is_merging ? merge_latencies : latencies).push_back(Clock::now() - call_start);
+        }
+        const Clock::duration total = Clock::now() - start;
+        search_server.WaitForMerges();
+        const Clock::duration total_with_merges = Clock::now() - start;
+        PrintCalls("AddDocument", latencies);
+        PrintCalls("AddDocument(merging)", merge_latencies);
+        std::cout << std::fixed << std::setprecision(0) << "  "
+                  << documents.size() / std::chrono::duration<double>(total).count() << " docs/s, " << documents.size() / std::chrono::duration<double>(total_with_merges).count()
+                  << " docs/s including remaining merges, " << search_server.GetSegmentCount() << " segments"
+                  << std::endl;
+    }
+
+    const size_t half = documents.size() / 2;
+    SegmentedSearchServer search_server(stop_words, seal_threshold, merge_factor);
+    for (size_t i = 0; i < half; ++i) {
+        search_server.AddDocument(documents[i].id, documents[i].text, documents[i].status, documents[i].ratings);
+    }
+    search_server.WaitForMerges();
+    MeasureLatency("FindTopDocuments(idle)", queries.size(), [&](size_t i) {
+        search_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+    });
+
+    std::atomic<bool> is_ingesting{true};
+    std::thread writer([&] {
+        for (size_t i = half; i < documents.size(); ++i) {
+            search_server.AddDocument(documents[i].id, documents[i].text, documents[i].status, documents[i].ratings);
+        }
+        is_ingesting = false;
+    });
+    std::vector<Clock::duration> latencies;
+    std::vector<Clock::duration> merge_latencies;
+    for (size_t i = 0; is_ingesting; ++i) {
+        const bool is_merging = search_server.IsMergeRunning();
+        const Clock::time_point call_start = Clock::now();
+        search_server.FindTopDocuments(queries[i % queries.size()], DocumentStatus::ACTUAL, top_k);
+        (is_merging ? merge_latencies : latencies).push_back(Clock::now() - call_start);
+    }
+    writer.join();
+    search_server.WaitForMerges();
+    PrintCalls("FindTopDocuments(ingesting)", latencies);
+    PrintCalls("FindTopDocuments(merging)", merge_latencies);
+}
+
+// ShardedSearchServer при разном числе шардов: скорость пакетного добавления корпуса, задержка одного
+// запроса и запросов в секунду, когда запросы идут одновременно из стольких потоков, сколько ядер
+void MeasureSharding(const std::string& stop_words, const std::vector<GeneratedDocument>& documents,
+                     const std::vector<std::string>& queries, size_t top_k) {
+    constexpr size_t BATCH_SIZE = 1000;
+    const size_t core_count = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "ShardedSearchServer, " << core_count << " cores" << std::endl;
+    for (const size_t shard_count : {size_t{1}, size_t{2}, size_t{4}, size_t{8}}) {
+        ShardedSearchServer search_server(stop_words, shard_count);
+        const Clock::time_point ingest_start = Clock::now();
+        for (size_t first = 0; first < documents.size(); first += BATCH_SIZE) {
+            std::vector<SearchServer::DocumentToAdd> batch;
+            for (size_t i = first; i < std::min(first + BATCH_SIZE, documents.size()); ++i) {
+                batch.push_back({documents[i].id, documents[i].text, documents[i].status, documents[i].ratings});
+            }
+            search_server.AddDocuments(batch);
+        }
+        const double ingest_rate = documents.size()
+                                   / std::chrono::duration<double>(Clock::now() - ingest_start).count();
+        MeasureLatency("FindTopDocuments(" + std::to_string(shard_count) + " shards)", queries.size(), [&](size_t i) {
+            search_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+        });
+
+        std::atomic<size_t> next_query{0};
+        std::vector<std::thread> clients;
+        const Clock::time_point start = Clock::now();
+        for (size_t client = 0; client < core_count; ++client) {
+            clients.emplace_back([&] {
+                for (size_t i = next_query++; i < queries.size(); i = next_query++) {
+                    search_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+                }
+            });
+        }
+        for (std::thread& client : clients) {
+            client.join();
+        }
+        const double query_rate = queries.size() / std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(0) << "  " << ingest_rate << " docs/s added, " << query_rate
+                  << " queries/s from " << core_count << " threads" << std::endl;
+    }
+}
+
+// пакетная обработка запросов (process_queries.h) при разном числе потоков планировщика параллельных
+// алгоритмов: запросов в секунду и ускорение относительно одного потока
+void MeasureBatchQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
+    const size_t core_count = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t thread_count = 1; thread_count < core_count; thread_count *= 2) {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(core_count);
+    std::cout << "ProcessQueries, " << queries.size() << " queries per batch, " << core_count << " cores"
+              << std::endl;
+    double single_thread_rate = 0.0;
+    for (const size_t thread_count : thread_counts) {
+        const tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, thread_count);
+        ProcessQueries(search_server, queries);
+        constexpr int ROUND_COUNT = 5;
+        const Clock::time_point start = Clock::now();
+        for (int round = 0; round < ROUND_COUNT; ++round) {
+            ProcessQueries(search_server, queries);
+        }
+        const double rate = ROUND_COUNT * queries.size()
+                            / std::chrono::duration<double>(Clock::now() - start).count();
+        if (thread_count == 1) {
+            single_thread_rate = rate;
+        }
+        std::cout << std::fixed << std::setprecision(0) << "  " << std::setw(3) << thread_count << " threads: "
+                  << std::setw(9) << rate << " queries/s, " << std::setprecision(2) << rate / single_thread_rate
+                  << "x" << std::endl;
+    }
+}
+
+// отбор top_k из всех найденных: полная сортировка против кучи TopDocuments на тех же документах.
+// Релевантности и рейтинги случайные, с повторами, как у документов с одинаковым набором слов запроса
+void MeasureTopSelection(size_t document_count) {
+    constexpr int ROUND_COUNT = 20;
+    std::mt19937_64 generator(7);
+    std::vector<Document> found(document_count);
+    for (size_t i = 0; i < document_count; ++i) {
+        found[i] = {static_cast<int>(i), static_cast<double>(generator() % 10000) / 1000.0,
+                    static_cast<int>(generator() % 10)};
+    }
+    std::cout << "top-K selection, " << document_count << " found documents" << std::endl;
+    for (const size_t top_k : {size_t{1}, size_t{5}, size_t{10}, size_t{100}, size_t{1000}}) {
+        const auto measure = [&](auto select) {
+            const Clock::time_point start = Clock::now();
+            for (int round = 0; round < ROUND_COUNT; ++round) {
+                if (select().size() != std::min(top_k, document_count)) {
+                    throw std::runtime_error("top-K selection lost documents");
+                }
+            }
+            return ToMicroseconds(Clock::now() - start) / ROUND_COUNT;
+        };
+        const double sort_us = measure([&] {
+            std::vector<Document> documents = found;
+            std::sort(documents.begin(), documents.end(), IsMoreRelevant);
+            documents.resize(std::min(top_k, documents.size()));
+            return documents;
+        });
+        const double heap_us = measure([&] {
+            TopDocuments top_documents(top_k);
+            for (const Document& document : found) {
+                top_documents.Add(document);
+            }
+            return top_documents.Extract();
+        });
+        std::cout << std::fixed << std::setprecision(1) << "  top " << std::left << std::setw(5) << top_k
+                  << std::right << " sort " << std::setw(9) << sort_us << " us, heap " << std::setw(9) << heap_us
+                  << " us, " << std::setprecision(2) << sort_us / heap_us << "x" << std::endl;
+    }
+}
+
+// обычные и сжатые списки документов: байт кучи индекса на вхождение слова в документ и время запросов
+void MeasurePostingListLayouts(const std::string& stop_words, const std::vector<GeneratedDocument>& documents,
+                               const std::vector<std::string>& queries, size_t top_k) {
+    using Layout = SearchServer::PostingListLayout;
+    std::cout << "posting list layouts" << std::endl;
+    double plain_bytes = 0.0;
+    for (const Layout layout : {Layout::PLAIN, Layout::COMPRESSED}) {
+        const bool is_compressed = layout == Layout::COMPRESSED;
+        const int64_t bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+        SearchServer search_server(stop_words);
+        search_server.SetPostingListLayout(layout);
+        for (const GeneratedDocument& document : documents) {
+            search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+        }
+        const double bytes = static_cast<double>(allocated_bytes.load(std::memory_order_relaxed) - bytes_before);
+        size_t posting_count = 0;
+        for (const int document_id : search_server) {
+            posting_count += search_server.GetWordFrequencies(document_id).size();
+        }
+        std::cout << std::fixed << std::setprecision(1)
+                  << (is_compressed ? "  compressed: " : "  plain:      ") << bytes / posting_count
+                  << " bytes of index per posting";
+        if (is_compressed) {
+            std::cout << ", " << (plain_bytes - bytes) / posting_count << " saved";
+        } else {
+            plain_bytes = bytes;
+        }
+        std::cout << " (" << posting_count << " postings)" << std::endl;
+        MeasureLatency(is_compressed ? "FindTopDocuments(compressed)" : "FindTopDocuments(plain)", queries.size(),
+                       [&](size_t i) {
+            search_server.FindTopDocuments(queries[i], DocumentStatus::ACTUAL, top_k);
+        });
+    }
+}
+
+// снимок индекса: сохранение и загрузка против построения того же индекса заново через AddDocument
+void MeasureSnapshot(const SearchServer& search_server, const std::string& stop_words,
+                     const std::vector<GeneratedDocument>& documents, const std::string& path) {
+    const auto milliseconds_since = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+    Clock::time_point start = Clock::now();
+    {
+        SearchServer rebuilt_server(stop_words);
+        for (const GeneratedDocument& document : documents) {
+            rebuilt_server.AddDocument(document.id, document.text, document.status, document.ratings);
+        }
+    }
+    const double rebuild_ms = milliseconds_since(start);
+    start = Clock::now();
+    SaveSnapshot(search_server, path);
+    const double save_ms = milliseconds_since(start);
+    const auto file_size = std::filesystem::file_size(path);
+    start = Clock::now();
+    const SearchServer loaded_server = LoadSnapshot(path);
+    const double load_ms = milliseconds_since(start);
+    std::filesystem::remove(path);
+    if (loaded_server.GetDocumentCount() != search_server.GetDocumentCount()) {
+        throw std::runtime_error("snapshot lost documents");
+    }
+    std::cout << "snapshot, " << std::fixed << std::setprecision(1) << file_size / 1e6 << " MB" << std::endl
+              << "  rebuild with AddDocument: " << rebuild_ms << " ms" << std::endl
+              << "  SaveSnapshot:             " << save_ms << " ms" << std::endl
+              << "  LoadSnapshot:             " << load_ms << " ms, " << rebuild_ms / load_ms
+              << "x faster than rebuild" << std::endl;
+}
+
+#ifndef SEARCH_SERVER_NO_PROFILING
+// стоимость выборочного замера: тот же поток запросов без замера и с замером каждого прохода стадии
+void MeasureStages(const SearchServer& search_server, const std::vector<GeneratedDocument>& documents,
+                   const std::vector<std::string>& queries, uint32_t sample_period) {
+    const auto run_queries = [&] {
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            search_server.FindTopDocuments(queries[i]);
+            search_server.MatchDocument(queries[i], documents[i * 7919 % documents.size()].id);
+        }
+        return ToMicroseconds(Clock::now() - start) / queries.size();
+    };
+    SearchProfiler::Disable();
+    const double disabled_us = run_queries();
+    SearchProfiler::Reset();
+    SearchProfiler::Enable(sample_period);
+    const double enabled_us = run_queries();
+    SearchProfiler::Disable();
+    std::cout << "stages, every " << sample_period << " pass sampled: " << std::fixed << std::setprecision(1)
+              << disabled_us << " us/query unsampled, " << enabled_us << " us/query sampled" << std::endl;
+    SearchProfiler::PrintStats(std::cout);
+}
+#endif
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        options = ParseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    CorpusGenerator generator(options.corpus);
+    std::vector<GeneratedDocument> documents;
+    std::vector<std::string> queries;
+    {
+        LOG_DURATION("corpus generation");
+        documents = generator.GenerateDocuments();
+        queries = generator.GenerateQueries(options.query_mix);
+    }
+    if (documents.empty() || queries.empty()) {
+        std::cerr << "nothing to measure" << std::endl;
+        return 1;
+    }
+    const std::string stop_words = generator.GetStopWords();
+    MeasureIngest(stop_words, documents);
+
+    SearchServer search_server(stop_words);
+    for (const GeneratedDocument& document : documents) {
+        search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    MeasureQueries(search_server, documents, queries, options.top_k);
+    MeasureQueryCache(search_server, queries, options.top_k, options.query_log_size, options.query_log_zipf,
+                      options.corpus.seed);
+    MeasureBatchQueries(search_server, queries);
+    MeasureConcurrentIngest(stop_words, documents, queries, options.top_k);
+    MeasureSegmentedIngest(stop_words, documents, queries, options.top_k, options.seal_threshold,
+                           options.merge_factor);
+    MeasureSharding(stop_words, documents, queries, options.top_k);
+    MeasureTopSelection(documents.size());
+    MeasurePostingListLayouts(stop_words, documents, queries, options.top_k);
+    MeasureSnapshot(search_server, stop_words, documents, options.snapshot_path);
+#ifndef SEARCH_SERVER_NO_PROFILING
+    MeasureStages(search_server, documents, queries, options.profile_sample_period);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// очередь между потоками с ограниченной ёмкостью: Push ждёт, пока в очереди есть место, поэтому
+// быстрый поставщик не уходит вперёд медленного потребителя больше чем на capacity элементов.
+// После Close очередь отдаёт оставшиеся элементы, новые не принимает, а ожидающие просыпаются
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+            : capacity_(capacity == 0 ? 1 : capacity) {
+    }
+
+    // false, если очередь закрыта; элемент тогда не добавляется
+    bool Push(T value) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [this] {
+            return is_closed_ || items_.size() < capacity_;
+        });
+        if (is_closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // пусто, если очередь закрыта и все элементы уже забраны
+    std::optional<T> Pop() {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [this] {
+            return is_closed_ || !items_.empty();
+        });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return value;
+    }
+
+    void Close() {
+        {
+            std::lock_guard guard(mutex_);
+            is_closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    bool is_closed_ = false;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+// загрузка корпуса в SearchServer потоковым загрузчиком (bulk_loader.h) с отчётом о ходе загрузки;
+// готовый индекс можно сохранить снимком (index_snapshot.h) для быстрого запуска сервера.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. bulk_load/main.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o bulk_load
+// Параметры - пары ключ=значение:
+//   input=<файл или - для стандартного ввода> stop_words="и в на" snapshot=<файл снимка>
+//   parsers=<потоков разбора> block_size=<байт> queue_capacity=<блоков>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "../bulk_loader.h"
+#include "../index_snapshot.h"
+#include "../search_server.h"
+
+int main(int argc, char* argv[]) {
+    std::string input_path = "-";
+    std::string stop_words;
+    std::string snapshot_path;
+    BulkLoadOptions options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view argument = argv[i];
+            const size_t separator = argument.find('=');
+            if (separator == std::string_view::npos) {
+                throw std::invalid_argument("expected key=value, got " + std::string(argument));
+            }
+            const std::string key(argument.substr(0, separator));
+            const std::string value(argument.substr(separator + 1));
+            if (key == "input") {
+                input_path = value;
+            } else if (key == "stop_words") {
+                stop_words = value;
+            } else if (key == "snapshot") {
+                snapshot_path = value;
+            } else if (key == "parsers") {
+                options.parser_count = std::stoul(value);
+            } else if (key == "block_size") {
+                options.block_size = std::stoul(value);
+            } else if (key == "queue_capacity") {
+                options.queue_capacity = std::stoul(value);
+            } else {
+                throw std::invalid_argument("unknown option " + key);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    options.on_progress = [](const BulkLoadStats& stats) {
+        std::cerr << std::fixed << std::setprecision(1) << stats.documents << " documents, "
+                  << stats.bytes / 1e6 << " MB, " << std::setprecision(0) << stats.GetDocumentsPerSecond()
+                  << " docs/s, " << std::setprecision(1) << stats.GetMegabytesPerSecond() << " MB/s" << std::endl;
+    };
+    try {
+        SearchServer search_server(stop_words);
+        if (input_path == "-") {
+            std::ios::sync_with_stdio(false);
+            LoadDocuments(search_server, std::cin, options);
+        } else {
+            LoadDocuments(search_server, input_path, options);
+        }
+        if (!snapshot_path.empty()) {
+            SaveSnapshot(search_server, snapshot_path);
+        }
+        std::cerr << "loaded " << search_server.GetDocumentCount() << " documents" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
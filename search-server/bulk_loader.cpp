@@ -0,0 +1,341 @@
+#include "bulk_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "bounded_queue.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// блок входа из целых строк; стадия разбора дописывает в него подготовленные документы.
+// Документы ссылаются на text, поэтому блоки передаются между стадиями по указателю и не перемещаются
+struct Block {
+    uint64_t sequence = 0;
+    // номер первой строки блока, с 1
+    uint64_t first_line_number = 1;
+    std::string text;
+    std::vector<SearchServer::PreparedDocument> documents;
+    std::vector<uint64_t> line_numbers;
+    // ошибка разбора строки: выбрасывается, когда вставка дойдёт до неё, после документов перед ней
+    std::exception_ptr error;
+};
+
+using BlockPtr = std::unique_ptr<Block>;
+
+struct DocumentLine {
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+    std::string_view text;
+};
+
+std::invalid_argument MakeLineError(uint64_t line_number, const std::string& message) {
+    return std::invalid_argument("line " + std::to_string(line_number) + ": " + message);
+}
+
+// часть строки до табуляции; сама строка укорачивается до остатка после неё
+std::string_view TakeField(std::string_view& line) {
+    const size_t tab = line.find('\t');
+    if (tab == std::string_view::npos) {
+        throw std::invalid_argument("expected id, status, ratings and text separated by tabs");
+    }
+    const std::string_view field = line.substr(0, tab);
+    line.remove_prefix(tab + 1);
+    return field;
+}
+
+int ParseInt(std::string_view text) {
+    int value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || text.empty()) {
+        throw std::invalid_argument("invalid number '" + std::string(text) + "'");
+    }
+    return value;
+}
+
+void ParseDocumentLine(std::string_view line, DocumentLine& document) {
+    document.id = ParseInt(TakeField(line));
+    const int status = ParseInt(TakeField(line));
+    if (status < static_cast<int>(DocumentStatus::ACTUAL) || status > static_cast<int>(DocumentStatus::REMOVED)) {
+        throw std::invalid_argument("invalid status " + std::to_string(status));
+    }
+    document.status = static_cast<DocumentStatus>(status);
+    std::string_view ratings = TakeField(line);
+    document.ratings.clear();
+    while (!ratings.empty()) {
+        const size_t space = std::min(ratings.find(' '), ratings.size());
+        if (space > 0) {
+            document.ratings.push_back(ParseInt(ratings.substr(0, space)));
+        }
+        ratings.remove_prefix(std::min(space + 1, ratings.size()));
+    }
+    document.text = line;
+}
+
+void ParseBlock(const SearchServer& search_server, Block& block) {
+    std::string_view text = block.text;
+    uint64_t line_number = block.first_line_number;
+    DocumentLine document;
+    for (; !text.empty(); ++line_number) {
+        const size_t line_end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, line_end);
+        text.remove_prefix(std::min(line_end + 1, text.size()));
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        try {
+            ParseDocumentLine(line, document);
+            block.documents.push_back(search_server.PrepareDocument(document.id, document.text, document.status,
+                                                                    document.ratings));
+            block.line_numbers.push_back(line_number);
+        } catch (const std::invalid_argument& e) {
+            block.error = std::make_exception_ptr(MakeLineError(line_number, e.what()));
+            return;
+        } catch (...) {
+            block.error = std::current_exception();
+            return;
+        }
+    }
+}
+
+// читает вход блоками примерно по block_size байт, разрезая его по концам строк
+void ReadBlocks(std::istream& input, size_t block_size, BoundedQueue<BlockPtr>& blocks) {
+    std::string tail;
+    uint64_t sequence = 0;
+    uint64_t line_number = 1;
+    while (true) {
+        BlockPtr block = std::make_unique<Block>();
+        std::string& text = block->text;
+        text = std::move(tail);
+        tail.clear();
+        const size_t tail_size = text.size();
+        text.resize(tail_size + block_size);
+        input.read(text.data() + tail_size, static_cast<std::streamsize>(block_size));
+        if (input.bad()) {
+            throw std::runtime_error("cannot read documents");
+        }
+        const size_t read_size = static_cast<size_t>(input.gcount());
+        text.resize(tail_size + read_size);
+        const bool is_last = read_size < block_size;
+        if (!is_last) {
+            // недочитанная строка переходит в следующий блок; строка длиннее блока копится целиком
+            const size_t last_line_end = text.rfind('\n');
+            if (last_line_end == std::string::npos) {
+                tail = std::move(text);
+                continue;
+            }
+            tail.assign(text, last_line_end + 1);
+            text.resize(last_line_end + 1);
+        }
+        if (!text.empty()) {
+            block->sequence = sequence++;
+            block->first_line_number = line_number;
+            line_number += std::count(text.begin(), text.end(), '\n');
+            if (!blocks.Push(std::move(block))) {
+                return;
+            }
+        }
+        if (is_last) {
+            return;
+        }
+    }
+}
+
+// окно блоков от первого ещё не вставленного: разборщик берётся за блок, только когда тот попал в окно.
+// Иначе один долгий блок держал бы вставку, а чтение и остальные разборщики уходили бы вперёд
+// и копили разобранные блоки в ожидании без ограничения
+class ReorderWindow {
+public:
+    explicit ReorderWindow(uint64_t size)
+            : size_(std::max<uint64_t>(size, 1)) {
+    }
+
+    // false, если окно закрыто
+    bool WaitFor(uint64_t sequence) {
+        std::unique_lock lock(mutex_);
+        moved_.wait(lock, [this, sequence] {
+            return is_closed_ || sequence < next_sequence_ + size_;
+        });
+        return !is_closed_;
+    }
+
+    void MoveTo(uint64_t next_sequence) {
+        {
+            std::lock_guard guard(mutex_);
+            next_sequence_ = next_sequence;
+        }
+        moved_.notify_all();
+    }
+
+    void Close() {
+        {
+            std::lock_guard guard(mutex_);
+            is_closed_ = true;
+        }
+        moved_.notify_all();
+    }
+
+private:
+    uint64_t size_;
+    std::mutex mutex_;
+    std::condition_variable moved_;
+    uint64_t next_sequence_ = 0;
+    bool is_closed_ = false;
+};
+
+// потоки конвейера: при выходе из загрузки, в том числе по исключению, очереди и окно закрываются,
+// чтобы потоки не остались ждать, и потоки дожидаются
+class PipelineThreads {
+public:
+    PipelineThreads(BoundedQueue<BlockPtr>& read_blocks, BoundedQueue<BlockPtr>& parsed_blocks,
+                    ReorderWindow& window)
+            : read_blocks_(read_blocks)
+            , parsed_blocks_(parsed_blocks)
+            , window_(window) {
+    }
+
+    PipelineThreads(const PipelineThreads&) = delete;
+    PipelineThreads& operator=(const PipelineThreads&) = delete;
+
+    ~PipelineThreads() {
+        read_blocks_.Close();
+        parsed_blocks_.Close();
+        window_.Close();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    template <typename Function>
+    void Start(Function function) {
+        threads_.emplace_back(std::move(function));
+    }
+
+private:
+    BoundedQueue<BlockPtr>& read_blocks_;
+    BoundedQueue<BlockPtr>& parsed_blocks_;
+    ReorderWindow& window_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace
+
+double BulkLoadStats::GetDocumentsPerSecond() const {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? documents / seconds : 0.0;
+}
+
+double BulkLoadStats::GetMegabytesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? bytes / 1e6 / seconds : 0.0;
+}
+
+BulkLoadStats LoadDocuments(SearchServer& search_server, std::istream& input, const BulkLoadOptions& options) {
+    const Clock::time_point start = Clock::now();
+    const size_t parser_count = options.parser_count > 0
+                                ? options.parser_count
+                                : std::max(2u, std::thread::hardware_concurrency()) - 1;
+    const size_t block_size = std::max<size_t>(options.block_size, 1);
+    BoundedQueue<BlockPtr> read_blocks(options.queue_capacity);
+    BoundedQueue<BlockPtr> parsed_blocks(options.queue_capacity);
+    // все разборщики заняты, и ещё очередь разобранных блоков: блок за окном ждёт, пока вставка не догонит
+    ReorderWindow window(parser_count + std::max<size_t>(options.queue_capacity, 1));
+    std::exception_ptr read_error;
+    std::atomic<size_t> running_parser_count = parser_count;
+
+    BulkLoadStats stats;
+    {
+        PipelineThreads threads(read_blocks, parsed_blocks, window);
+        threads.Start([&] {
+            try {
+                ReadBlocks(input, block_size, read_blocks);
+            } catch (...) {
+                read_error = std::current_exception();
+            }
+            read_blocks.Close();
+        });
+        // разбор только читает стоп-слова сервера, поэтому идёт одновременно со вставкой
+        for (size_t i = 0; i < parser_count; ++i) {
+            threads.Start([&] {
+                while (std::optional<BlockPtr> block = read_blocks.Pop()) {
+                    if (!window.WaitFor((*block)->sequence)) {
+                        break;
+                    }
+                    ParseBlock(search_server, **block);
+                    if (!parsed_blocks.Push(std::move(*block))) {
+                        break;
+                    }
+                }
+                if (--running_parser_count == 0) {
+                    parsed_blocks.Close();
+                }
+            });
+        }
+
+        // разборщики заканчивают блоки не по порядку: обогнавшие ждут здесь, пока не вставлены предыдущие.
+        // Их не больше размера окна
+        std::map<uint64_t, BlockPtr> waiting_blocks;
+        uint64_t next_sequence = 0;
+        Clock::time_point last_progress = start;
+        while (std::optional<BlockPtr> parsed_block = parsed_blocks.Pop()) {
+            const uint64_t sequence = (*parsed_block)->sequence;
+            waiting_blocks.emplace(sequence, std::move(*parsed_block));
+            for (auto block_it = waiting_blocks.begin();
+                 block_it != waiting_blocks.end() && block_it->first == next_sequence;
+                 block_it = waiting_blocks.erase(block_it), ++next_sequence) {
+                Block& block = *block_it->second;
+                for (size_t i = 0; i < block.documents.size(); ++i) {
+                    try {
+                        search_server.AddDocument(block.documents[i]);
+                    } catch (const std::invalid_argument& e) {
+                        throw MakeLineError(block.line_numbers[i], e.what());
+                    }
+                }
+                stats.documents += block.documents.size();
+                if (block.error) {
+                    std::rethrow_exception(block.error);
+                }
+                stats.bytes += block.text.size();
+            }
+            window.MoveTo(next_sequence);
+            const Clock::time_point now = Clock::now();
+            if (options.on_progress && now - last_progress >= options.progress_interval) {
+                last_progress = now;
+                stats.elapsed = now - start;
+                options.on_progress(stats);
+            }
+        }
+    }
+    if (read_error) {
+        std::rethrow_exception(read_error);
+    }
+    stats.elapsed = Clock::now() - start;
+    if (options.on_progress) {
+        options.on_progress(stats);
+    }
+    return stats;
+}
+
+BulkLoadStats LoadDocuments(SearchServer& search_server, const std::string& path, const BulkLoadOptions& options) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return LoadDocuments(search_server, input, options);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include "search_server.h"
+
+// потоковая загрузка корпуса в SearchServer. Документ на строке:
+//   id<TAB>статус<TAB>рейтинги через пробел<TAB>текст
+// статус - номер DocumentStatus (0 - ACTUAL, 1 - IRRELEVANT, 2 - BANNED, 3 - REMOVED); пустые строки пропускаются.
+// Загрузка идёт конвейером из трёх стадий на своих потоках, связанных очередями ограниченной ёмкости:
+// чтение блоками по block_size байт, разбор строк и текстов на слова без стоп-слов (PrepareDocument,
+// parser_count потоков) и вставка в индекс на вызывающем потоке. Стадия, ушедшая вперёд на queue_capacity
+// блоков, ждёт следующую, а разборщик не берётся за блок дальше parser_count + queue_capacity блоков
+// от первого ещё не вставленного, поэтому память конвейера ограничена, даже если какой-то блок разбирается
+// долго. Документы вставляются в порядке строк.
+// Ошибка в строке (формат, недопустимые символы, занятый id) - исключение invalid_argument с номером строки,
+// документы до неё уже добавлены; ошибка чтения - runtime_error
+struct BulkLoadStats {
+    uint64_t documents = 0;
+    // прочитано и обработано байт входа
+    uint64_t bytes = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    double GetDocumentsPerSecond() const;
+    double GetMegabytesPerSecond() const;
+};
+
+struct BulkLoadOptions {
+    // 0 - по числу ядер без одного (одно занято вставкой), но не меньше одного
+    size_t parser_count = 0;
+    size_t block_size = 1 << 20;
+    // блоков в каждой из очередей между стадиями
+    size_t queue_capacity = 4;
+    // вызывается на вызывающем потоке не чаще раза в progress_interval и один раз в конце загрузки
+    std::function<void(const BulkLoadStats&)> on_progress;
+    std::chrono::milliseconds progress_interval{1000};
+};
+
+BulkLoadStats LoadDocuments(SearchServer& search_server, std::istream& input, const BulkLoadOptions& options = {});
+BulkLoadStats LoadDocuments(SearchServer& search_server, const std::string& path, const BulkLoadOptions& options = {});
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "compressed_posting_list.h"
+
+#include <algorithm>
+
+namespace {
+
+void WriteVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t ReadVarint(const uint8_t* bytes, size_t& offset) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        const uint8_t byte = bytes[offset++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+} // namespace
+
+void CompressedPostingList::Append(int document, uint32_t term_count) {
+    // первая запись блока хранит номер целиком, чтобы блок распаковывался независимо от предыдущих
+    int previous = 0;
+    if (size_ % BLOCK_SIZE == 0) {
+        skips_.push_back({document, static_cast<uint32_t>(bytes_.size())});
+    } else {
+        previous = skips_.back().last_document;
+        skips_.back().last_document = document;
+    }
+    WriteVarint(bytes_, static_cast<uint32_t>(document - previous));
+    WriteVarint(bytes_, term_count);
+    ++size_;
+}
+
+void CompressedPostingList::Erase(int document) {
+    const size_t block = FindBlock(document);
+    if (block == skips_.size()) {
+        return;
+    }
+    std::vector<int> documents;
+    std::vector<uint32_t> term_counts;
+    // хвост списка начиная с блока документа распаковывается и собирается заново
+    size_t offset = skips_[block].offset;
+    const size_t tail_size = size_ - block * BLOCK_SIZE;
+    int current = 0;
+    for (size_t i = 0; i < tail_size; ++i) {
+        const uint32_t delta = ReadVarint(bytes_.data(), offset);
+        current = (i % BLOCK_SIZE == 0) ? static_cast<int>(delta) : current + static_cast<int>(delta);
+        const uint32_t term_count = ReadVarint(bytes_.data(), offset);
+        if (current != document) {
+            documents.push_back(current);
+            term_counts.push_back(term_count);
+        }
+    }
+    if (documents.size() == tail_size) {
+        return;
+    }
+    bytes_.resize(skips_[block].offset);
+    skips_.resize(block);
+    size_ = block * BLOCK_SIZE;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        Append(documents[i], term_counts[i]);
+    }
+}
+
+bool CompressedPostingList::Contains(int document) const {
+    return Cursor(*this).SkipTo(document);
+}
+
+void CompressedPostingList::Decode(std::vector<int>& documents, std::vector<uint32_t>& term_counts) const {
+    documents.resize(size_);
+    term_counts.resize(size_);
+    size_t offset = 0;
+    int current = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        const uint32_t delta = ReadVarint(bytes_.data(), offset);
+        current = (i % BLOCK_SIZE == 0) ? static_cast<int>(delta) : current + static_cast<int>(delta);
+        documents[i] = current;
+        term_counts[i] = ReadVarint(bytes_.data(), offset);
+    }
+}
+
+size_t CompressedPostingList::size() const {
+    return size_;
+}
+
+bool CompressedPostingList::empty() const {
+    return size_ == 0;
+}
+
+size_t CompressedPostingList::GetByteSize() const {
+    return bytes_.size() + skips_.size() * sizeof(SkipEntry);
+}
+
+size_t CompressedPostingList::FindBlock(int document) const {
+    return std::partition_point(skips_.begin(), skips_.end(), [document](const SkipEntry& skip) {
+        return skip.last_document < document;
+    }) - skips_.begin();
+}
+
+CompressedPostingList::Cursor::Cursor(const CompressedPostingList& posting_list)
+        : posting_list_(&posting_list) {
+    if (!posting_list_->skips_.empty()) {
+        EnterBlock(0);
+    }
+}
+
+bool CompressedPostingList::Cursor::SkipTo(int document) {
+    const auto& skips = posting_list_->skips_;
+    if (block_ == skips.size()) {
+        return false;
+    }
+    if (current_ >= document) {
+        return current_ == document;
+    }
+    if (skips[block_].last_document < document) {
+        // документ точно не в текущем блоке: ищем нужный блок по указателям пропуска
+        const auto next_block = std::partition_point(skips.begin() + block_ + 1, skips.end(),
+                                                     [document](const SkipEntry& skip) {
+            return skip.last_document < document;
+        });
+        block_ = next_block - skips.begin();
+        if (block_ == skips.size()) {
+            return false;
+        }
+        EnterBlock(block_);
+    }
+    while (current_ < document && left_in_block_ > 0) {
+        const uint32_t delta = ReadVarint(posting_list_->bytes_.data(), offset_);
+        current_ = current_ < 0 ? static_cast<int>(delta) : current_ + static_cast<int>(delta);
+        ReadVarint(posting_list_->bytes_.data(), offset_);
+        --left_in_block_;
+    }
+    return current_ == document;
+}
+
+void CompressedPostingList::Cursor::EnterBlock(size_t block) {
+    block_ = block;
+    offset_ = posting_list_->skips_[block].offset;
+    left_in_block_ = std::min(BLOCK_SIZE, posting_list_->size_ - block * BLOCK_SIZE);
+    current_ = -1;
+}
\ No newline at end of file
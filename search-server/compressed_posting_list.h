@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Сжатый список документов слова: номера документов (по возрастанию) хранятся разностями
+// с предыдущим номером, разности и количества вхождений слова в документ - в формате varint
+// (7 бит на байт). Список разбит на блоки по BLOCK_SIZE записей; для каждого блока хранится
+// указатель пропуска (последний номер блока и смещение), поэтому поиск документа распаковывает
+// один блок, а не весь список.
+class CompressedPostingList {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;
+
+    // документ должен быть больше всех уже добавленных
+    void Append(int document, uint32_t term_count);
+
+    // удаление документа перепаковывает список начиная с блока, где лежал документ
+    void Erase(int document);
+
+    bool Contains(int document) const;
+
+    void Decode(std::vector<int>& documents, std::vector<uint32_t>& term_counts) const;
+
+    size_t size() const;
+    bool empty() const;
+
+    // объём сжатых данных вместе с таблицей пропусков
+    size_t GetByteSize() const;
+
+    // последовательный обход с возможностью перескочить вперёд по указателям пропуска
+    class Cursor {
+    public:
+        explicit Cursor(const CompressedPostingList& posting_list);
+
+        // переходит к первому документу не меньше заданного; true, если именно он есть в списке.
+        // Аргументы последовательных вызовов не должны убывать
+        bool SkipTo(int document);
+
+    private:
+        const CompressedPostingList* posting_list_;
+        size_t block_ = 0;
+        size_t offset_ = 0;          // позиция следующей записи в байтах
+        size_t left_in_block_ = 0;   // сколько записей блока ещё не прочитано
+        int current_ = -1;           // последний прочитанный номер документа, -1 до начала обхода
+
+        void EnterBlock(size_t block);
+    };
+
+private:
+    struct SkipEntry {
+        int last_document;
+        uint32_t offset;
+    };
+
+    std::vector<uint8_t> bytes_;
+    std::vector<SkipEntry> skips_;
+    size_t size_ = 0;
+
+    // номер блока, в котором может лежать документ (первый блок, чей последний номер не меньше)
+    size_t FindBlock(int document) const;
+};
\ No newline at end of file
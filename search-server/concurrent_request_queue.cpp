@@ -0,0 +1,133 @@
+#include "concurrent_request_queue.h"
+
+#include <algorithm>
+#include <thread>
+
+ConcurrentRequestQueue::ConcurrentRequestQueue(const SearchServer& search_server)
+        : search_server_(search_server) {
+}
+
+std::vector<Document> ConcurrentRequestQueue::AddFindRequest(std::string_view raw_query, DocumentStatus status) {
+    return TimeRequest([&] {
+        return search_server_.FindTopDocuments(raw_query, status);
+    });
+}
+
+std::vector<Document> ConcurrentRequestQueue::AddFindRequest(std::string_view raw_query) {
+    return TimeRequest([&] {
+        return search_server_.FindTopDocuments(raw_query);
+    });
+}
+
+void ConcurrentRequestQueue::AddRequest(size_t results_num, std::chrono::nanoseconds latency) {
+    // новый запрос - новая минута; ячейка, где лежал запрос min_in_day_ минут назад, переходит к нему
+    const uint64_t time = current_time_.fetch_add(1, std::memory_order_relaxed) + 1;
+    Slot& slot = slots_[GetSlotIndex(time)];
+    uint64_t tag = slot.tag.load(std::memory_order_relaxed);
+    while (true) {
+        // поток отстал, и ячейку уже занял запрос на min_in_day_ минут новее: этот запрос вне окна
+        if (tag >> 2 >= time) {
+            return;
+        }
+        // ячейку ещё дописывает запрос старше; он держит её на время одной записи,
+        // а чтобы его догнать, должны прийти min_in_day_ запросов, так что ожидание редкое и короткое
+        if (tag & BUSY_FLAG) {
+            std::this_thread::yield();
+            tag = slot.tag.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.tag.compare_exchange_weak(tag, time << 2 | BUSY_FLAG, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    // метка занятости становится видна раньше нового времени ответа
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.latency_ns.store(latency.count(), std::memory_order_relaxed);
+    slot.tag.store(time << 2 | (results_num == 0 ? NO_RESULTS_FLAG : 0), std::memory_order_release);
+}
+
+int ConcurrentRequestQueue::GetNoResultRequests() const {
+    uint64_t now = 0;
+    const std::vector<Record> window = CollectWindow(now);
+    return std::count_if(window.begin(), window.end(), [](const Record& record) {
+        return record.is_empty;
+    });
+}
+
+ConcurrentRequestQueue::Stats ConcurrentRequestQueue::GetWindowStats() const {
+    uint64_t now = 0;
+    const std::vector<Record> window = CollectWindow(now);
+    return ComputeStats(window.begin(), window.end());
+}
+
+std::vector<ConcurrentRequestQueue::Stats> ConcurrentRequestQueue::GetTimeBucketStats() const {
+    uint64_t now = 0;
+    std::vector<Record> window = CollectWindow(now);
+    std::sort(window.begin(), window.end(), [](const Record& lhs, const Record& rhs) {
+        return lhs.time < rhs.time;
+    });
+    // интервалы отсчитываются от текущей минуты назад, последний заканчивается на ней
+    std::vector<Stats> buckets(TIME_BUCKET_COUNT);
+    auto first = window.begin();
+    for (uint64_t bucket = 0; bucket < TIME_BUCKET_COUNT; ++bucket) {
+        const uint64_t age_end = (TIME_BUCKET_COUNT - 1 - bucket) * TIME_BUCKET_SIZE;
+        const auto last = std::find_if(first, window.end(), [now, age_end](const Record& record) {
+            return now - record.time < age_end;
+        });
+        buckets[bucket] = ComputeStats(first, last);
+        first = last;
+    }
+    return buckets;
+}
+
+size_t ConcurrentRequestQueue::GetSlotIndex(uint64_t time) {
+    // соседние номера попадают в разные кэш-линии: номер i идёт в линию i % LINES
+    constexpr size_t line_count = min_in_day_ / SLOTS_PER_CACHE_LINE;
+    const size_t position = time % min_in_day_;
+    return position % line_count * SLOTS_PER_CACHE_LINE + position / line_count;
+}
+
+std::vector<ConcurrentRequestQueue::Record> ConcurrentRequestQueue::CollectWindow(uint64_t& now) const {
+    now = current_time_.load(std::memory_order_relaxed);
+    std::vector<Record> window;
+    window.reserve(min_in_day_);
+    for (const Slot& slot : slots_) {
+        const uint64_t tag = slot.tag.load(std::memory_order_acquire);
+        const uint64_t time = tag >> 2;
+        // ячейка пуста, дописывается, устарела или уже занята запросом новее момента чтения
+        if (time == 0 || (tag & BUSY_FLAG) || time > now || min_in_day_ <= now - time) {
+            continue;
+        }
+        const auto latency = std::chrono::nanoseconds(slot.latency_ns.load(std::memory_order_relaxed));
+        // пока читали время ответа, ячейку мог занять более новый запрос
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.tag.load(std::memory_order_relaxed) != tag) {
+            continue;
+        }
+        window.push_back({time, (tag & NO_RESULTS_FLAG) != 0, latency});
+    }
+    return window;
+}
+
+ConcurrentRequestQueue::Stats ConcurrentRequestQueue::ComputeStats(std::vector<Record>::const_iterator first,
+                                                                  std::vector<Record>::const_iterator last) {
+    Stats stats;
+    stats.requests = last - first;
+    if (stats.requests == 0) {
+        return stats;
+    }
+    std::vector<std::chrono::nanoseconds> latencies;
+    latencies.reserve(stats.requests);
+    for (auto it = first; it != last; ++it) {
+        stats.no_result_requests += it->is_empty;
+        latencies.push_back(it->latency);
+    }
+    const auto percentile = [&latencies](size_t percent) {
+        const auto nth = latencies.begin() + (latencies.size() - 1) * percent / 100;
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    };
+    stats.latency_p50 = percentile(50);
+    stats.latency_p99 = percentile(99);
+    return stats;
+}
\ No newline at end of file
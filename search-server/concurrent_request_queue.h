@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "search_server.h"
+
+// RequestQueue, в который запросы записывают одновременно много потоков. Окно то же: последние
+// min_in_day_ запросов по логическим "минутам" (номер запроса), и подсчёт запросов без результата в нём точный.
+// Запись не берёт блокировок: номер запроса выдаёт атомарный счётчик, а сам запрос пишется в свою ячейку
+// кольцевого буфера на min_in_day_ ячеек по схеме seqlock: ячейка сначала помечается занятой (CAS, который
+// удаётся, только если в ячейке запрос старше), затем пишется время ответа и публикуется итоговая метка.
+// Запрос, чью ячейку уже занял запрос новее, в окно и так не входит и не пишется. Окно точное для
+// завершённых записей: запрос, который ещё пишется, появляется в статистике после публикации метки.
+// Соседние номера раскладываются по разным кэш-линиям, чтобы потоки не делили линии друг с другом.
+// Статистика собирается при чтении обходом буфера, поэтому чтение стоит O(min_in_day_), а запись - O(1)
+class ConcurrentRequestQueue {
+public:
+    // окно делится на TIME_BUCKET_COUNT интервалов по TIME_BUCKET_SIZE запросов ("часов")
+    static constexpr uint64_t TIME_BUCKET_SIZE = 60;
+    static constexpr uint64_t TIME_BUCKET_COUNT = 24;
+
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t no_result_requests = 0;
+        std::chrono::nanoseconds latency_p50{0};
+        std::chrono::nanoseconds latency_p99{0};
+    };
+
+    explicit ConcurrentRequestQueue(const SearchServer& search_server);
+
+    // SearchServer только читается, поэтому методы поиска можно вызывать из любого числа потоков
+    std::vector<Document> AddFindRequest(std::string_view raw_query, DocumentStatus status);
+    std::vector<Document> AddFindRequest(std::string_view raw_query);
+
+    template <typename DocumentPredicate>
+    std::vector<Document> AddFindRequest(std::string_view raw_query, DocumentPredicate document_predicate);
+
+    // учёт запроса, выполненного в обход очереди (например, через ConcurrentSearchServer)
+    void AddRequest(size_t results_num, std::chrono::nanoseconds latency);
+
+    int GetNoResultRequests() const;
+
+    // статистика по всему окну и по его интервалам, от старых к новым; у интервала, в который
+    // ещё не попал ни один запрос, requests == 0
+    Stats GetWindowStats() const;
+    std::vector<Stats> GetTimeBucketStats() const;
+
+private:
+    const static int min_in_day_ = 1440;
+
+    // tag = (номер запроса << 2) | (результатов нет) << 1 | BUSY_FLAG; 0 - ячейка ещё не записана.
+    // Пока стоит BUSY_FLAG, время ответа в ячейке может быть недописанным, и читатели ячейку пропускают
+    static constexpr uint64_t BUSY_FLAG = 1;
+    static constexpr uint64_t NO_RESULTS_FLAG = 2;
+
+    struct Slot {
+        std::atomic<uint64_t> tag{0};
+        std::atomic<uint64_t> latency_ns{0};
+    };
+
+    struct Record {
+        uint64_t time;
+        bool is_empty;
+        std::chrono::nanoseconds latency;
+    };
+
+    static constexpr size_t SLOTS_PER_CACHE_LINE = 64 / sizeof(Slot);
+    static_assert(min_in_day_ % SLOTS_PER_CACHE_LINE == 0);
+
+    const SearchServer& search_server_;
+    alignas(64) std::atomic<uint64_t> current_time_{0};
+    alignas(64) std::array<Slot, min_in_day_> slots_;
+
+    static size_t GetSlotIndex(uint64_t time);
+
+    // записи окна на текущий момент и сам момент
+    std::vector<Record> CollectWindow(uint64_t& now) const;
+
+    static Stats ComputeStats(std::vector<Record>::const_iterator first, std::vector<Record>::const_iterator last);
+
+    template <typename Search>
+    std::vector<Document> TimeRequest(Search search);
+};
+
+template <typename Search>
+std::vector<Document> ConcurrentRequestQueue::TimeRequest(Search search) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Document> result = search();
+    AddRequest(result.size(), std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> ConcurrentRequestQueue::AddFindRequest(std::string_view raw_query,
+                                                             DocumentPredicate document_predicate) {
+    return TimeRequest([&] {
+        return search_server_.FindTopDocuments(raw_query, document_predicate);
+    });
+}
\ No newline at end of file
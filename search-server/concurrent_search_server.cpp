@@ -0,0 +1,51 @@
+#include "concurrent_search_server.h"
+
+#include <execution>
+#include <set>
+#include <stdexcept>
+
+ConcurrentSearchServer::ConcurrentSearchServer(SearchServer search_server)
+        : search_server_(std::move(search_server)) {
+}
+
+void ConcurrentSearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                                         const std::vector<int>& ratings) {
+    // стоп-слова не меняются после создания SearchServer, поэтому разбор не требует блокировки
+    const auto prepared_document = search_server_.PrepareDocument(document_id, document, status, ratings);
+    std::lock_guard write_guard(write_mutex_);
+    std::unique_lock lock(mutex_);
+    search_server_.AddDocument(prepared_document);
+}
+
+void ConcurrentSearchServer::AddDocuments(const std::vector<SearchServer::DocumentToAdd>& documents) {
+    const auto prepared_documents = search_server_.PrepareDocuments(std::execution::par, documents);
+    std::lock_guard write_guard(write_mutex_);
+    // пока держится write_mutex_, набор id не меняется, поэтому проверенный пакет вставится целиком
+    std::set<int> batch_ids;
+    for (const auto& prepared_document : prepared_documents) {
+        if (search_server_.HasDocument(prepared_document.id) || !batch_ids.insert(prepared_document.id).second) {
+            throw std::invalid_argument("repeat document id");
+        }
+    }
+    for (const auto& prepared_document : prepared_documents) {
+        std::unique_lock lock(mutex_);
+        search_server_.AddDocument(prepared_document);
+    }
+}
+
+void ConcurrentSearchServer::RemoveDocument(int document_id) {
+    std::lock_guard write_guard(write_mutex_);
+    std::unique_lock lock(mutex_);
+    search_server_.RemoveDocument(document_id);
+}
+
+std::tuple<std::vector<std::string>, DocumentStatus> ConcurrentSearchServer::MatchDocument(
+        std::string_view raw_query, int document_id) const {
+    std::shared_lock lock(mutex_);
+    return search_server_.MatchDocument(raw_query, document_id);
+}
+
+int ConcurrentSearchServer::GetDocumentCount() const {
+    std::shared_lock lock(mutex_);
+    return search_server_.GetDocumentCount();
+}
\ No newline at end of file
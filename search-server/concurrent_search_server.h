@@ -0,0 +1,45 @@
+#pragma once
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "search_server.h"
+
+// SearchServer, который можно одновременно пополнять и опрашивать из разных потоков.
+// Поиск берёт разделяемую блокировку, изменения - исключительную. Разбор текста документа
+// выполняется до взятия блокировки, так что читатели ждут писателя только на время вставки в списки
+class ConcurrentSearchServer {
+public:
+    explicit ConcurrentSearchServer(SearchServer search_server);
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                     const std::vector<int>& ratings);
+
+    // тексты разбираются параллельно без блокировки, затем каждый документ вставляется
+    // под своей короткой блокировкой, чтобы поиск не ждал окончания всего пакета.
+    // Если какой-то документ некорректен или его id занят либо повторяется в пакете, исключение
+    // invalid_argument выбрасывается до вставки первого документа
+    void AddDocuments(const std::vector<SearchServer::DocumentToAdd>& documents);
+
+    void RemoveDocument(int document_id);
+
+    template <typename... Args>
+    std::vector<Document> FindTopDocuments(Args&&... args) const {
+        std::shared_lock lock(mutex_);
+        return search_server_.FindTopDocuments(std::forward<Args>(args)...);
+    }
+
+    std::tuple<std::vector<std::string>, DocumentStatus> MatchDocument(std::string_view raw_query,
+                                                                       int document_id) const;
+
+    int GetDocumentCount() const;
+
+private:
+    // изменения выполняются по одному: пакет вставляется под несколькими короткими блокировками mutex_,
+    // и между ними другой писатель не должен занять проверенные id
+    std::mutex write_mutex_;
+    mutable std::shared_mutex mutex_;
+    SearchServer search_server_;
+};
\ No newline at end of file
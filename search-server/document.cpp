@@ -2,6 +2,14 @@
 
 using namespace std::string_literals;
 
+std::ostream& operator<<(std::ostream& out, const Document& document) {
+    out << "{ "s
+        << "document_id = "s << document.id << ", "s
+        << "relevance = "s << document.relevance << ", "s
+        << "rating = "s << document.rating << " }"s;
+    return out;
+}
+
 void PrintDocument(const Document& document) {
     std::cout << "{ "s
               << "document_id = "s << document.id << ", "s
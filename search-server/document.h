@@ -21,13 +21,9 @@ struct Document {
 };
 
 
-std::ostream& operator<<(std::ostream& out, const Document& document) {
-    out << "{ "s
-        << "document_id = "s << document.id << ", "s
-        << "relevance = "s << document.relevance << ", "s
-        << "rating = "s << document.rating << " }"s;
-    return out;
-}
+std::ostream& operator<<(std::ostream& out, const Document& document);
+
+void PrintDocument(const Document& document);
 
 // объявление перечисленных типов
 enum class DocumentStatus {
@@ -0,0 +1,42 @@
+#pragma once
+#include <type_traits>
+#include "document.h"
+
+// типовые фильтры для FindTopDocuments. SearchServer распознаёт их на этапе компиляции и проверяет документ
+// по одному плотному столбцу атрибутов, без вызова предиката с полной записью документа, а при обходе
+// с отсечением отбрасывает не прошедшие фильтр документы до подсчёта релевантности.
+// Фильтры - обычные предикаты (id, статус, рейтинг), поэтому подходят всюду, где принимается предикат;
+// произвольная лямбда по-прежнему работает через общий путь
+
+// статус документа равен status; им пользуется FindTopDocuments(raw_query, status)
+struct StatusFilter {
+    DocumentStatus status;
+
+    bool operator()(int, DocumentStatus document_status, int) const {
+        return document_status == status;
+    }
+};
+
+// рейтинг документа больше threshold
+struct RatingAboveFilter {
+    int threshold;
+
+    bool operator()(int, DocumentStatus, int rating) const {
+        return rating > threshold;
+    }
+};
+
+// id документа в диапазоне [first_id, last_id]
+struct DocumentIdRangeFilter {
+    int first_id;
+    int last_id;
+
+    bool operator()(int document_id, DocumentStatus, int) const {
+        return first_id <= document_id && document_id <= last_id;
+    }
+};
+
+template <typename Predicate>
+inline constexpr bool IS_ATTRIBUTE_FILTER = std::is_same_v<Predicate, StatusFilter>
+                                            || std::is_same_v<Predicate, RatingAboveFilter>
+                                            || std::is_same_v<Predicate, DocumentIdRangeFilter>;
\ No newline at end of file
@@ -0,0 +1,374 @@
+#include "index_snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'S', 'R', 'C', 'H', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+// секции выравниваются, чтобы массивы чисел в отображённом файле лежали по естественным границам
+constexpr uint64_t SECTION_ALIGNMENT = 8;
+
+enum Section : uint32_t {
+    STOP_WORDS,
+    DOCUMENTS,
+    TERMS,
+    POSTING_DOCUMENTS,
+    POSTING_TERM_FREQS,
+    SECTION_COUNT
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+};
+
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+uint32_t ComputeCrc32(const char* data, size_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t i = 0; i < result.size(); ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+            result[i] = crc;
+        }
+        return result;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// содержимое одной секции, накапливаемое перед записью в файл
+class SectionWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Append(&value, sizeof(value));
+    }
+
+    void WriteString(std::string_view str) {
+        Write(static_cast<uint32_t>(str.size()));
+        Append(str.data(), str.size());
+    }
+
+    template <typename T>
+    void WriteArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Append(values, count * sizeof(T));
+    }
+
+    const std::string& GetData() const {
+        return data_;
+    }
+
+private:
+    std::string data_;
+
+    void Append(const void* data, size_t size) {
+        data_.append(static_cast<const char*>(data), size);
+    }
+};
+
+// последовательное чтение секции отображённого файла с проверкой выхода за её границы
+class SectionReader {
+public:
+    SectionReader(const char* data, size_t size)
+            : data_(data)
+            , size_(size) {
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string_view ReadString() {
+        const uint32_t size = Read<uint32_t>();
+        return {Take(size), size};
+    }
+
+    template <typename T>
+    void ReadArray(std::vector<T>& values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > (size_ - position_) / sizeof(T)) {
+            throw std::runtime_error("snapshot section is truncated");
+        }
+        values.resize(count);
+        std::memcpy(values.data(), Take(count * sizeof(T)), count * sizeof(T));
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+
+    const char* Take(size_t size) {
+        if (size > size_ - position_) {
+            throw std::runtime_error("snapshot section is truncated");
+        }
+        const char* result = data_ + position_;
+        position_ += size;
+        return result;
+    }
+};
+
+// файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open snapshot " + path);
+        }
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+            close(fd);
+            throw std::runtime_error("cannot stat snapshot " + path);
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+        if (size_ > 0) {
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("cannot map snapshot " + path);
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    const char* GetData() const {
+        return data_;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace
+
+void SaveSnapshot(const SearchServer& search_server, const std::string& path) {
+    // живые документы получают новые номера подряд, с сохранением порядка, чтобы списки остались отсортированными
+    std::vector<int> new_index(search_server.documents_.size(), -1);
+    for (const auto& [_, document_index] : search_server.document_id_to_index_) {
+        new_index[document_index] = 0;
+    }
+    std::vector<SectionWriter> sections(SECTION_COUNT);
+
+    sections[STOP_WORDS].Write(static_cast<uint64_t>(search_server.stop_words_.size()));
+    for (const std::string& stop_word : search_server.stop_words_) {
+        sections[STOP_WORDS].WriteString(stop_word);
+    }
+
+    int document_count = 0;
+    for (size_t document_index = 0; document_index < new_index.size(); ++document_index) {
+        if (new_index[document_index] == 0) {
+            new_index[document_index] = document_count++;
+        }
+    }
+    sections[DOCUMENTS].Write(static_cast<uint64_t>(document_count));
+    for (size_t document_index = 0; document_index < new_index.size(); ++document_index) {
+        if (new_index[document_index] < 0) {
+            continue;
+        }
+        const auto& attributes = search_server.document_attributes_;
+        sections[DOCUMENTS].Write(static_cast<int32_t>(attributes.ids[document_index]));
+        sections[DOCUMENTS].Write(static_cast<int32_t>(attributes.ratings[document_index]));
+        sections[DOCUMENTS].Write(static_cast<int32_t>(attributes.statuses[document_index]));
+        sections[DOCUMENTS].Write(static_cast<int32_t>(search_server.documents_[document_index].word_count));
+    }
+
+    // слова пишутся по алфавиту: при загрузке прямой индекс документа заполняется дописыванием в конец
+    // и сразу получается отсортированным
+    std::vector<int> term_ids;
+    for (size_t term_id = 0; term_id < search_server.postings_.size(); ++term_id) {
+        if (search_server.postings_[term_id].size() > 0) {
+            term_ids.push_back(static_cast<int>(term_id));
+        }
+    }
+    std::sort(term_ids.begin(), term_ids.end(), [&search_server](int lhs, int rhs) {
+        return search_server.words_[lhs] < search_server.words_[rhs];
+    });
+    sections[TERMS].Write(static_cast<uint64_t>(term_ids.size()));
+    // сжатые списки в файле хранятся в обычном виде, чтобы загрузка оставалась копированием массивов
+    SearchServer::PostingsBuffer buffer;
+    for (const int term_id : term_ids) {
+        const auto postings = search_server.ViewPostings(search_server.postings_[term_id], buffer);
+        sections[TERMS].WriteString(search_server.words_[term_id]);
+        sections[TERMS].Write(static_cast<uint64_t>(postings.size));
+        std::vector<int32_t> documents;
+        documents.reserve(postings.size);
+        for (size_t i = 0; i < postings.size; ++i) {
+            documents.push_back(new_index[postings.documents[i]]);
+        }
+        sections[POSTING_DOCUMENTS].WriteArray(documents.data(), documents.size());
+        sections[POSTING_TERM_FREQS].WriteArray(postings.term_freqs, postings.size);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.section_count = SECTION_COUNT;
+    std::vector<SectionEntry> table(SECTION_COUNT);
+    uint64_t offset = sizeof(SnapshotHeader) + SECTION_COUNT * sizeof(SectionEntry);
+    for (uint32_t section = 0; section < SECTION_COUNT; ++section) {
+        offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        const std::string& data = sections[section].GetData();
+        table[section] = {offset, data.size(), ComputeCrc32(data.data(), data.size()), 0};
+        offset += data.size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("cannot create snapshot " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+    for (uint32_t section = 0; section < SECTION_COUNT; ++section) {
+        const std::string padding(table[section].offset - static_cast<uint64_t>(out.tellp()), '\0');
+        out.write(padding.data(), padding.size());
+        out.write(sections[section].GetData().data(), sections[section].GetData().size());
+    }
+    if (!out) {
+        throw std::runtime_error("cannot write snapshot " + path);
+    }
+}
+
+SearchServer LoadSnapshot(const std::string& path) {
+    const MappedFile file(path);
+    if (file.GetSize() < sizeof(SnapshotHeader) + SECTION_COUNT * sizeof(SectionEntry)) {
+        throw std::runtime_error("snapshot " + path + " is truncated");
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(path + " is not a search server snapshot");
+    }
+    if (header.version != SNAPSHOT_VERSION || header.section_count != SECTION_COUNT) {
+        throw std::runtime_error("unsupported snapshot version " + std::to_string(header.version));
+    }
+    std::vector<SectionReader> sections;
+    for (uint32_t section = 0; section < SECTION_COUNT; ++section) {
+        SectionEntry entry;
+        std::memcpy(&entry, file.GetData() + sizeof(SnapshotHeader) + section * sizeof(SectionEntry), sizeof(entry));
+        if (entry.offset > file.GetSize() || entry.size > file.GetSize() - entry.offset) {
+            throw std::runtime_error("snapshot " + path + " is truncated");
+        }
+        const char* data = file.GetData() + entry.offset;
+        if (ComputeCrc32(data, entry.size) != entry.checksum) {
+            throw std::runtime_error("snapshot " + path + " is corrupted: checksum mismatch");
+        }
+        sections.emplace_back(data, entry.size);
+    }
+
+    std::vector<std::string_view> stop_words(sections[STOP_WORDS].Read<uint64_t>());
+    for (std::string_view& stop_word : stop_words) {
+        stop_word = sections[STOP_WORDS].ReadString();
+    }
+    SearchServer search_server(stop_words);
+
+    auto& documents = search_server.documents_;
+    const auto document_count = sections[DOCUMENTS].Read<uint64_t>();
+    for (size_t document_index = 0; document_index < document_count; ++document_index) {
+        const int document_id = sections[DOCUMENTS].Read<int32_t>();
+        const int rating = sections[DOCUMENTS].Read<int32_t>();
+        const int32_t status = sections[DOCUMENTS].Read<int32_t>();
+        const int word_count = sections[DOCUMENTS].Read<int32_t>();
+        if (search_server.document_id_to_index_.count(document_id)) {
+            throw std::runtime_error("snapshot " + path + " is corrupted: repeated document id");
+        }
+        if (status < static_cast<int32_t>(DocumentStatus::ACTUAL)
+            || status > static_cast<int32_t>(DocumentStatus::REMOVED)) {
+            throw std::runtime_error("snapshot " + path + " is corrupted: invalid document status");
+        }
+        search_server.AppendDocument(document_id, rating, static_cast<DocumentStatus>(status), word_count);
+    }
+
+    const auto term_count = sections[TERMS].Read<uint64_t>();
+    search_server.word_to_term_id_.reserve(term_count);
+    search_server.postings_.resize(term_count);
+    std::vector<size_t> document_word_counts(documents.size());
+    for (size_t term_id = 0; term_id < term_count; ++term_id) {
+        // слова записаны по алфавиту без повторов; на этом держится двоичный поиск в прямом индексе
+        const std::string_view word = sections[TERMS].ReadString();
+        if (term_id > 0 && word <= search_server.words_.back()) {
+            throw std::runtime_error("snapshot " + path + " is corrupted: terms are repeated or out of order");
+        }
+        search_server.words_.emplace_back(word);
+        search_server.word_to_term_id_.emplace(search_server.words_.back(), static_cast<int>(term_id));
+        const auto posting_size = sections[TERMS].Read<uint64_t>();
+        auto& posting_list = search_server.postings_[term_id];
+        sections[POSTING_DOCUMENTS].ReadArray(posting_list.documents, posting_size);
+        sections[POSTING_TERM_FREQS].ReadArray(posting_list.term_freqs, posting_size);
+        posting_list.log_document_freq = std::log(static_cast<double>(posting_size));
+        posting_list.max_term_freq = posting_list.term_freqs.empty()
+                ? 0.0 : *std::max_element(posting_list.term_freqs.begin(), posting_list.term_freqs.end());
+        for (size_t i = 0; i < posting_list.documents.size(); ++i) {
+            const int document_index = posting_list.documents[i];
+            if (document_index < 0 || static_cast<size_t>(document_index) >= documents.size()) {
+                throw std::runtime_error("snapshot " + path + " is corrupted: unknown document");
+            }
+            if (i > 0 && document_index <= posting_list.documents[i - 1]) {
+                throw std::runtime_error("snapshot " + path + " is corrupted: posting list is not sorted");
+            }
+            ++document_word_counts[document_index];
+        }
+    }
+
+    // прямой индекс восстанавливается по спискам документов слов
+    for (size_t document_index = 0; document_index < documents.size(); ++document_index) {
+        documents[document_index].word_freqs.reserve(document_word_counts[document_index]);
+    }
+    for (size_t term_id = 0; term_id < term_count; ++term_id) {
+        const std::string_view word = search_server.words_[term_id];
+        const auto& posting_list = search_server.postings_[term_id];
+        for (size_t i = 0; i < posting_list.documents.size(); ++i) {
+            documents[posting_list.documents[i]].word_freqs.emplace_back(word, posting_list.term_freqs[i]);
+        }
+    }
+    return search_server;
+}
\ No newline at end of file
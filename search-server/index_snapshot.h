@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include "search_server.h"
+
+// Бинарный снимок индекса: стоп-слова, рейтинги, статусы и длины документов, словарь и списки документов слов.
+// Файл начинается с заголовка (сигнатура, версия формата, таблица секций), у каждой секции
+// своя контрольная сумма CRC32. Удалённые документы в снимок не попадают, внутренние номера
+// документов при сохранении уплотняются.
+// Ошибки ввода-вывода, несовпадение версии и повреждённые данные - исключение std::runtime_error.
+void SaveSnapshot(const SearchServer& search_server, const std::string& path);
+
+// файл отображается в память (mmap), массивы списков документов копируются в индекс целиком,
+// без повторного разбиения текстов на слова
+SearchServer LoadSnapshot(const std::string& path);
\ No newline at end of file
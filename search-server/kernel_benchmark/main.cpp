@@ -0,0 +1,141 @@
+// замер вычислительных ядер обхода списков документов (scoring_kernels.h) на списках длиной от 10 до 10M:
+// нс на элемент списка для скалярной и выбранной по процессору версий и проверка, что их результаты совпадают.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. kernel_benchmark/main.cpp scoring_kernels.cpp -o kernel_benchmark
+// Параметры - пары ключ=значение: max_length=<длина самого длинного списка> seed=<зерно генератора>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../scoring_kernels.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// пространство номеров документов: списки разной длины равномерно разрежены по нему
+constexpr size_t DOCUMENT_COUNT = 20'000'000;
+// на каждую длину списка ядро обрабатывает примерно столько элементов, сколько нужно для устойчивого замера
+constexpr size_t POSTINGS_PER_MEASUREMENT = 20'000'000;
+constexpr int COLUMN_WIDTH = 14;
+
+struct PostingSample {
+    std::vector<int> documents;
+    std::vector<double> term_freqs;
+    // отсортированное подмножество documents (около трети) вперемешку с номерами, которых в documents нет
+    std::vector<int> other;
+};
+
+PostingSample GeneratePostings(std::mt19937_64& generator, size_t length) {
+    PostingSample sample;
+    const size_t step = DOCUMENT_COUNT / length;
+    for (size_t i = 0; i < length; ++i) {
+        sample.documents.push_back(static_cast<int>(i * step + generator() % step));
+        sample.term_freqs.push_back(static_cast<double>(generator() % 100) / 37.0);
+    }
+    for (size_t i = 0; i < length / 3; ++i) {
+        sample.other.push_back(sample.documents[generator() % length]);
+        sample.other.push_back(static_cast<int>(generator() % DOCUMENT_COUNT));
+    }
+    std::sort(sample.other.begin(), sample.other.end());
+    sample.other.erase(std::unique(sample.other.begin(), sample.other.end()), sample.other.end());
+    return sample;
+}
+
+// среднее время operation() в наносекундах на элемент списка
+template <typename Operation>
+double MeasureNanosecondsPerPosting(size_t length, size_t repetitions, Operation operation) {
+    operation();
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        operation();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / repetitions / length;
+}
+
+// печатает время скалярной и выбранной по процессору версий ядра отбора позиций (разность или пересечение);
+// true, если они отобрали одни и те же позиции
+using SelectPositions = size_t (*)(const int*, size_t, const int*, size_t, uint32_t*);
+
+bool MeasureSelect(const PostingSample& sample, size_t repetitions,
+                   SelectPositions scalar, SelectPositions dispatched) {
+    const size_t length = sample.documents.size();
+    std::vector<uint32_t> scalar_positions(length);
+    std::vector<uint32_t> dispatched_positions(length);
+    size_t scalar_count = 0;
+    size_t dispatched_count = 0;
+    const double scalar_ns = MeasureNanosecondsPerPosting(length, repetitions, [&] {
+        scalar_count = scalar(sample.documents.data(), length, sample.other.data(), sample.other.size(),
+                              scalar_positions.data());
+    });
+    const double dispatched_ns = MeasureNanosecondsPerPosting(length, repetitions, [&] {
+        dispatched_count = dispatched(sample.documents.data(), length, sample.other.data(), sample.other.size(),
+                                      dispatched_positions.data());
+    });
+    const bool is_same = scalar_count == dispatched_count
+                         && std::equal(scalar_positions.begin(), scalar_positions.begin() + scalar_count,
+                                       dispatched_positions.begin());
+    std::cout << std::setw(COLUMN_WIDTH) << scalar_ns << std::setw(COLUMN_WIDTH) << dispatched_ns
+              << (is_same ? "" : "  MISMATCH");
+    return is_same;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t max_length = 10'000'000;
+    uint64_t seed = 42;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view argument = argv[i];
+            const size_t separator = argument.find('=');
+            if (separator == std::string_view::npos) {
+                throw std::invalid_argument("expected key=value, got " + std::string(argument));
+            }
+            const std::string key(argument.substr(0, separator));
+            const std::string value(argument.substr(separator + 1));
+            if (key == "max_length") {
+                max_length = std::min<size_t>(std::stoul(value), DOCUMENT_COUNT);
+            } else if (key == "seed") {
+                seed = std::stoull(value);
+            } else {
+                throw std::invalid_argument("unknown option " + key);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    std::vector<double> scores(DOCUMENT_COUNT);
+    std::vector<uint8_t> matched(DOCUMENT_COUNT);
+    bool is_same = true;
+    std::cout << "ns per posting" << std::endl << std::setw(COLUMN_WIDTH) << "length";
+    for (const char* column : {"accumulate", "difference", "(dispatched)", "intersection", "(dispatched)"}) {
+        std::cout << std::setw(COLUMN_WIDTH) << column;
+    }
+    std::cout << std::endl << std::fixed << std::setprecision(2);
+    for (size_t length = 10; length <= max_length; length *= 10) {
+        const PostingSample sample = GeneratePostings(generator, length);
+        const size_t repetitions = std::max<size_t>(1, POSTINGS_PER_MEASUREMENT / length);
+        std::cout << std::setw(COLUMN_WIDTH) << length << std::setw(COLUMN_WIDTH)
+                  << MeasureNanosecondsPerPosting(length, repetitions, [&] {
+                         AccumulateScores(sample.documents.data(), sample.term_freqs.data(), length, 1.7,
+                                          scores.data(), matched.data());
+                     });
+        is_same = MeasureSelect(sample, repetitions, DifferenceSortedScalar, DifferenceSorted) && is_same;
+        is_same = MeasureSelect(sample, repetitions, IntersectSortedScalar, IntersectSorted) && is_same;
+        std::cout << std::endl;
+    }
+    if (!is_same) {
+        std::cerr << "dispatched kernels disagree with the scalar ones" << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
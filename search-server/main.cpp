@@ -3,6 +3,7 @@
 #include "read_input_functions.h"
 #include "string_processing.h"
 #include "search_server.h"
+#include "remove_duplicates.h"
 #include "request_queue.h"
 
 using namespace std;
@@ -28,4 +29,10 @@ int main() {
     // первый запрос удален, 1437 запросов с нулевым результатом
     request_queue.AddFindRequest("sparrow"s);
     cout << "Total empty requests: "s << request_queue.GetNoResultRequests() << endl;
+
+    // тот же набор слов, что у документа 4, в другом порядке и с повтором
+    search_server.AddDocument(6, "sparrow Eugene big dog dog"s, DocumentStatus::ACTUAL, {1, 2});
+    for (const int document_id : RemoveDuplicates(search_server)) {
+        cout << "Found duplicate document id "s << document_id << endl;
+    }
 }
\ No newline at end of file
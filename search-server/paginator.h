@@ -1,5 +1,11 @@
 #pragma once
-#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 
 using namespace std::string_literals;
@@ -42,36 +48,97 @@ std::ostream& operator<<(std::ostream& out, const IteratorRange<Iterator>& range
     return out;
 }
 
+// страницы не хранятся, а вычисляются при обходе: Paginator помнит только границы диапазона
+// и размер страницы, итератор страниц держит текущую страницу. Создание Paginator ничего не стоит,
+// а до последних страниц доходит только тот, кто их действительно обходит
 template <typename Iterator>
 class Paginator {
 public:
-    Paginator(Iterator begin, Iterator end, size_t page_size) {
-        for (size_t left = distance(begin, end); left > 0;) {
-            const size_t current_page_size = std::min(page_size, left);
-            const Iterator current_page_end = next(begin, current_page_size);
-            pages_.push_back({begin, current_page_end});
-
-            left -= current_page_size;
-            begin = current_page_end;
+    // страница создаётся при разыменовании и возвращается по значению, поэтому итератор только входной
+    class PageIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = IteratorRange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        PageIterator(Iterator page_begin, Iterator end, size_t page_size)
+                : page_begin_(page_begin)
+                , page_end_(AdvanceUpTo(page_begin, page_size, end))
+                , end_(end)
+                , page_size_(page_size) {
+        }
+
+        value_type operator*() const {
+            return {page_begin_, page_end_};
+        }
+
+        PageIterator& operator++() {
+            page_begin_ = page_end_;
+            page_end_ = AdvanceUpTo(page_begin_, page_size_, end_);
+            return *this;
+        }
+
+        PageIterator operator++(int) {
+            PageIterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const PageIterator& other) const {
+            return page_begin_ == other.page_begin_;
+        }
+
+        bool operator!=(const PageIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        Iterator page_begin_;
+        Iterator page_end_;
+        Iterator end_;
+        size_t page_size_;
+
+        // сдвиг на count позиций, но не дальше end; итераторы произвольного доступа сдвигаются сразу
+        static Iterator AdvanceUpTo(Iterator it, size_t count, Iterator end) {
+            using Category = typename std::iterator_traits<Iterator>::iterator_category;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+                return it + std::min<std::ptrdiff_t>(count, end - it);
+            } else {
+                for (; count > 0 && it != end; --count) {
+                    ++it;
+                }
+                return it;
+            }
+        }
+    };
+
+    Paginator(Iterator begin, Iterator end, size_t page_size)
+            : begin_(begin)
+            , end_(end)
+            , page_size_(page_size) {
+        if (page_size_ == 0) {
+            throw std::invalid_argument("page size must be positive");
         }
     }
 
-    auto begin() const {
-        return pages_.begin();
+    PageIterator begin() const {
+        return {begin_, end_, page_size_};
     }
 
-    auto end() const {
-        return pages_.end();
+    PageIterator end() const {
+        return {end_, end_, page_size_};
     }
 
     size_t size() const {
-        return pages_.size();
+        return (static_cast<size_t>(distance(begin_, end_)) + page_size_ - 1) / page_size_;
     }
 
 private:
-//В таком случае внутри объекта Paginator вы просто спрячете вектор
-// таких вот IteratorRange и будете заполнять его в конструкторе объекта Paginator.
-    std::vector<IteratorRange<Iterator>> pages_;
+    Iterator begin_;
+    Iterator end_;
+    size_t page_size_;
 };
 
 
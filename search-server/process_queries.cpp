@@ -0,0 +1,97 @@
+#include "process_queries.h"
+
+#include <algorithm>
+#include <exception>
+#include <execution>
+
+std::vector<std::vector<Document>> ProcessQueries(
+        const SearchServer& search_server,
+        const std::vector<std::string>& queries) {
+    std::vector<std::vector<Document>> results(queries.size());
+    // исключение, вылетевшее из параллельного алгоритма, завершает программу, поэтому ошибки собираются вручную
+    std::vector<std::exception_ptr> errors(queries.size());
+    std::transform(std::execution::par, queries.begin(), queries.end(), results.begin(),
+                   [&search_server, &queries, &errors](const std::string& query) {
+        try {
+            return search_server.FindTopDocuments(query);
+        } catch (...) {
+            errors[&query - queries.data()] = std::current_exception();
+            return std::vector<Document>{};
+        }
+    });
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
+}
+
+JoinedDocuments::Iterator::Iterator(OuterIterator outer, OuterIterator outer_end)
+        : outer_(outer)
+        , outer_end_(outer_end) {
+    SkipEmpty();
+}
+
+JoinedDocuments::Iterator::reference JoinedDocuments::Iterator::operator*() const {
+    return (*outer_)[inner_];
+}
+
+JoinedDocuments::Iterator::pointer JoinedDocuments::Iterator::operator->() const {
+    return &(*outer_)[inner_];
+}
+
+JoinedDocuments::Iterator& JoinedDocuments::Iterator::operator++() {
+    if (++inner_ == outer_->size()) {
+        ++outer_;
+        inner_ = 0;
+        SkipEmpty();
+    }
+    return *this;
+}
+
+JoinedDocuments::Iterator JoinedDocuments::Iterator::operator++(int) {
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+bool JoinedDocuments::Iterator::operator==(const Iterator& other) const {
+    return outer_ == other.outer_ && inner_ == other.inner_;
+}
+
+bool JoinedDocuments::Iterator::operator!=(const Iterator& other) const {
+    return !(*this == other);
+}
+
+void JoinedDocuments::Iterator::SkipEmpty() {
+    while (outer_ != outer_end_ && outer_->empty()) {
+        ++outer_;
+    }
+}
+
+JoinedDocuments::JoinedDocuments(std::vector<std::vector<Document>> results)
+        : results_(std::move(results)) {
+}
+
+JoinedDocuments::Iterator JoinedDocuments::begin() const {
+    return {results_.begin(), results_.end()};
+}
+
+JoinedDocuments::Iterator JoinedDocuments::end() const {
+    return {results_.end(), results_.end()};
+}
+
+size_t JoinedDocuments::size() const {
+    size_t size = 0;
+    for (const auto& documents : results_) {
+        size += documents.size();
+    }
+    return size;
+}
+
+JoinedDocuments ProcessQueriesJoined(
+        const SearchServer& search_server,
+        const std::vector<std::string>& queries) {
+    return JoinedDocuments(ProcessQueries(search_server, queries));
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include <iterator>
+#include <string>
+#include <vector>
+#include "document.h"
+#include "search_server.h"
+
+// обработка пакета запросов: запросы выполняются параллельно на общем (только для чтения) SearchServer,
+// i-й элемент результата совпадает с search_server.FindTopDocuments(queries[i]). Если какой-то запрос
+// некорректен, после обработки пакета выбрасывается исключение первого по порядку из них
+std::vector<std::vector<Document>> ProcessQueries(
+        const SearchServer& search_server,
+        const std::vector<std::string>& queries);
+
+// результаты пакета запросов одной последовательностью документов; документы не копируются
+// в общий контейнер, а обходятся на месте в порядке запросов
+class JoinedDocuments {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Document;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Document*;
+        using reference = const Document&;
+
+        using OuterIterator = std::vector<std::vector<Document>>::const_iterator;
+
+        Iterator(OuterIterator outer, OuterIterator outer_end);
+
+        reference operator*() const;
+        pointer operator->() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        OuterIterator outer_;
+        OuterIterator outer_end_;
+        size_t inner_ = 0;
+
+        // пропускаем запросы без результатов
+        void SkipEmpty();
+    };
+
+    explicit JoinedDocuments(std::vector<std::vector<Document>> results);
+
+    Iterator begin() const;
+    Iterator end() const;
+    size_t size() const;
+
+private:
+    std::vector<std::vector<Document>> results_;
+};
+
+JoinedDocuments ProcessQueriesJoined(
+        const SearchServer& search_server,
+        const std::vector<std::string>& queries);
\ No newline at end of file
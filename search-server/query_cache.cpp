@@ -0,0 +1,83 @@
+#include "query_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+// корзин не больше, чем записей: иначе каждая держала бы хотя бы одну запись, и всего их было бы больше capacity
+size_t GetBucketCount(size_t capacity, size_t bucket_count) {
+    if (bucket_count == 0) {
+        throw std::invalid_argument("query cache needs at least one bucket");
+    }
+    return capacity == 0 ? 1 : std::min(capacity, bucket_count);
+}
+
+} // namespace
+
+QueryCache::QueryCache(size_t capacity, size_t bucket_count)
+        : bucket_capacity_(capacity / GetBucketCount(capacity, bucket_count))
+        , buckets_(GetBucketCount(capacity, bucket_count)) {
+}
+
+std::vector<Document> QueryCache::FindTopDocuments(const SearchServer& search_server, std::string_view raw_query,
+                                                   DocumentStatus status, size_t top_k) {
+    std::string key = search_server.NormalizeQuery(raw_query);
+    key += '\0';
+    key += std::to_string(static_cast<int>(status));
+    key += '\0';
+    key += std::to_string(top_k);
+    // версия берётся до поиска: если индекс изменится во время поиска, запись сразу окажется устаревшей
+    const uint64_t generation = search_server.GetGeneration();
+    Bucket& bucket = GetBucket(key);
+    {
+        std::lock_guard guard(bucket.mutex);
+        const auto it = bucket.index.find(key);
+        if (it != bucket.index.end()) {
+            if (it->second->second.generation == generation) {
+                bucket.entries.splice(bucket.entries.begin(), bucket.entries, it->second);
+                ++hit_count_;
+                return it->second->second.documents;
+            }
+            bucket.entries.erase(it->second);
+            bucket.index.erase(it);
+        }
+    }
+    ++miss_count_;
+    std::vector<Document> documents = search_server.FindTopDocuments(raw_query, status, top_k);
+    if (bucket_capacity_ == 0) {
+        return documents;
+    }
+    std::lock_guard guard(bucket.mutex);
+    // пока шёл поиск, тот же запрос мог быть посчитан и сохранён другим потоком; запись по более старой
+    // версии индекса заменяется, по более новой - остаётся
+    const auto it = bucket.index.find(key);
+    if (it != bucket.index.end()) {
+        Entry& entry = it->second->second;
+        if (entry.generation < generation) {
+            entry = {generation, documents};
+        }
+        bucket.entries.splice(bucket.entries.begin(), bucket.entries, it->second);
+        return documents;
+    }
+    if (bucket.entries.size() == bucket_capacity_) {
+        bucket.index.erase(bucket.entries.back().first);
+        bucket.entries.pop_back();
+    }
+    bucket.entries.emplace_front(std::move(key), Entry{generation, documents});
+    bucket.index.emplace(bucket.entries.front().first, bucket.entries.begin());
+    return documents;
+}
+
+uint64_t QueryCache::GetHitCount() const {
+    return hit_count_;
+}
+
+uint64_t QueryCache::GetMissCount() const {
+    return miss_count_;
+}
+
+QueryCache::Bucket& QueryCache::GetBucket(const std::string& key) {
+    return buckets_[std::hash<std::string>{}(key) % buckets_.size()];
+}
\ No newline at end of file
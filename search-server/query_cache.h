@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "document.h"
+#include "search_server.h"
+
+// кэш результатов FindTopDocuments, ограниченный по числу записей, с вытеснением давно не запрошенных (LRU).
+// Ключ - нормализованный запрос (SearchServer::NormalizeQuery), статус и длина топа, поэтому
+// "cat -dog" и "-dog cat cat" попадают в одну запись. Запись помнит версию индекса
+// (SearchServer::GetGeneration), при которой посчитана, и после любого изменения индекса считается промахом.
+// Ключи раскладываются по корзинам со своим мьютексом, так что кэшем можно
+// пользоваться из нескольких потоков одновременно
+class QueryCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    // capacity == 0 отключает кэш: каждый запрос выполняется заново и считается промахом.
+    // Записи делятся между корзинами поровну с округлением вниз, поэтому всего их не больше capacity;
+    // корзин не больше capacity. bucket_count == 0 - исключение invalid_argument
+    explicit QueryCache(size_t capacity = DEFAULT_CAPACITY, size_t bucket_count = 16);
+
+    std::vector<Document> FindTopDocuments(const SearchServer& search_server, std::string_view raw_query,
+                                           DocumentStatus status = DocumentStatus::ACTUAL,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT);
+
+    uint64_t GetHitCount() const;
+    uint64_t GetMissCount() const;
+
+private:
+    struct Entry {
+        uint64_t generation;
+        std::vector<Document> documents;
+    };
+
+    // список - порядок использования (в начале самые свежие), словарь ссылается на его элементы
+    struct Bucket {
+        std::mutex mutex;
+        std::list<std::pair<std::string, Entry>> entries;
+        std::unordered_map<std::string_view, std::list<std::pair<std::string, Entry>>::iterator> index;
+    };
+
+    size_t bucket_capacity_;
+    std::vector<Bucket> buckets_;
+    std::atomic<uint64_t> hit_count_ = 0;
+    std::atomic<uint64_t> miss_count_ = 0;
+
+    Bucket& GetBucket(const std::string& key);
+};
\ No newline at end of file
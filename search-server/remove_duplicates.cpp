@@ -0,0 +1,39 @@
+#include "remove_duplicates.h"
+
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct WordSetHasher {
+    size_t operator()(const std::vector<std::string_view>& words) const {
+        size_t hash = words.size();
+        for (const std::string_view word : words) {
+            hash = hash * 37 + std::hash<std::string_view>{}(word);
+        }
+        return hash;
+    }
+};
+
+} // namespace
+
+std::vector<int> RemoveDuplicates(SearchServer& search_server) {
+    std::unordered_set<std::vector<std::string_view>, WordSetHasher> word_sets;
+    std::vector<int> duplicate_ids;
+    // документы обходятся по возрастанию id, поэтому из группы дублей остаётся документ с наименьшим id
+    for (const int document_id : search_server) {
+        std::vector<std::string_view> words;
+        for (const auto& [word, _] : search_server.GetWordFrequencies(document_id)) {
+            words.push_back(word);
+        }
+        if (!word_sets.insert(std::move(words)).second) {
+            duplicate_ids.push_back(document_id);
+        }
+    }
+    for (const int document_id : duplicate_ids) {
+        search_server.RemoveDocument(document_id);
+    }
+    return duplicate_ids;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <vector>
+#include "search_server.h"
+
+// удаляет документы, набор слов которых совпадает с набором слов документа с меньшим id
+// (частоты слов не учитываются); возвращает id удалённых документов по возрастанию
+std::vector<int> RemoveDuplicates(SearchServer& search_server);
\ No newline at end of file
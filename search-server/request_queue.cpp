@@ -1,13 +1,13 @@
 #include "request_queue.h"
 
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentStatus status) {
-    const auto result = search_server_.FindTopDocuments(raw_query, status);
+std::vector<Document> RequestQueue::AddFindRequest(std::string_view raw_query, DocumentStatus status) {
+    const auto result = cache_.FindTopDocuments(search_server_, raw_query, status);
     AddRequest(result.size());
     return result;
 }
 
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query) {
-    const auto result = search_server_.FindTopDocuments(raw_query);
+std::vector<Document> RequestQueue::AddFindRequest(std::string_view raw_query) {
+    const auto result = cache_.FindTopDocuments(search_server_, raw_query);
     AddRequest(result.size());
     return result;
 }
@@ -16,6 +16,14 @@ int RequestQueue::GetNoResultRequests() const {
     return no_results_requests_;
 }
 
+uint64_t RequestQueue::GetCacheHits() const {
+    return cache_.GetHitCount();
+}
+
+uint64_t RequestQueue::GetCacheMisses() const {
+    return cache_.GetMissCount();
+}
+
 void RequestQueue::AddRequest(int results_num) {
     // новый запрос - новая секунда
     ++current_time_;
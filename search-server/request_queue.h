@@ -1,25 +1,33 @@
 #pragma once
 #include <deque>
 #include <cstdint>
+#include "query_cache.h"
 #include "search_server.h"
 
 class RequestQueue {
 public:
-    explicit RequestQueue(const SearchServer& search_server)
+    // запросы со статусом проходят через кэш результатов на cache_capacity записей (0 - без кэша)
+    explicit RequestQueue(const SearchServer& search_server, size_t cache_capacity = QueryCache::DEFAULT_CAPACITY)
             : search_server_(search_server)
             , no_results_requests_(0)
-            , current_time_(0) {
+            , current_time_(0)
+            , cache_(cache_capacity) {
     }//конструктор класса с начальными значениями
 
-    std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentStatus status);
-    std::vector<Document> AddFindRequest(const std::string& raw_query);
+    std::vector<Document> AddFindRequest(std::string_view raw_query, DocumentStatus status);
+    std::vector<Document> AddFindRequest(std::string_view raw_query);
 
-    // сделаем "обертки" для всех методов поиска, чтобы сохранять результаты для нашей статистики
+    // сделаем "обертки" для всех методов поиска, чтобы сохранять результаты для нашей статистики.
+    // Запросы с предикатом не кэшируются: у произвольной функции нет ключа, по которому их сравнить
     template <typename DocumentPredicate>
-    std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate);
+    std::vector<Document> AddFindRequest(std::string_view raw_query, DocumentPredicate document_predicate);
 
     int GetNoResultRequests() const;
 
+    // сколько запросов обслужено из кэша и сколько выполнено поиском
+    uint64_t GetCacheHits() const;
+    uint64_t GetCacheMisses() const;
+
 private:
     struct QueryResult {
         uint64_t timestamp;
@@ -30,12 +38,13 @@ private:
     int no_results_requests_;
     uint64_t current_time_;
     const static int min_in_day_ = 1440;
+    QueryCache cache_;
 
     void AddRequest(int results_num);
 };
 
 template <typename DocumentPredicate>
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate) {
+std::vector<Document> RequestQueue::AddFindRequest(std::string_view raw_query, DocumentPredicate document_predicate) {
     const auto result = search_server_.FindTopDocuments(raw_query, document_predicate);
     AddRequest(result.size());
     return result;
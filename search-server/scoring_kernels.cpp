@@ -0,0 +1,128 @@
+#include "scoring_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEARCH_SERVER_X86 1
+#endif
+
+// векторная версия (умножение по 4 + gather/поэлементная запись) на AVX2 оказалась не быстрее:
+// обход упирается в случайные обращения к scores, а не в арифметику
+void AccumulateScores(const int* documents, const double* term_freqs, size_t count,
+                      double inverse_document_freq, double* scores, uint8_t* matched) {
+    for (size_t i = 0; i < count; ++i) {
+        const double impact = term_freqs[i] * inverse_document_freq;
+        scores[documents[i]] += impact;
+        matched[documents[i]] = 1;
+    }
+}
+
+namespace {
+
+// общий проход для разности и пересечения: позиции documents, найденные (KEEP_FOUND) или
+// не найденные в other
+template <bool KEEP_FOUND>
+size_t SelectPositionsScalar(const int* documents, size_t count, const int* other, size_t other_count,
+                             uint32_t* positions) {
+    size_t position_count = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < count; ++i) {
+        while (j < other_count && other[j] < documents[i]) {
+            ++j;
+        }
+        const bool found = j < other_count && other[j] == documents[i];
+        if (found == KEEP_FOUND) {
+            positions[position_count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return position_count;
+}
+
+#ifdef SEARCH_SERVER_X86
+
+// слияние блоками по 8: блок документов сравнивается со всеми 8 поворотами блока other,
+// найденные совпадения копятся в маске, пока блок документов не будет пройден целиком;
+// затем сдвигается тот блок, чей максимум меньше (или оба при равенстве)
+template <bool KEEP_FOUND>
+__attribute__((target("avx2")))
+size_t SelectPositionsAvx2(const int* documents, size_t count, const int* other, size_t other_count,
+                           uint32_t* positions) {
+    size_t position_count = 0;
+    size_t i = 0;
+    size_t j = 0;
+    unsigned found_mask = 0;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= count && j + 8 <= other_count) {
+        const __m256i document_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(documents + i));
+        __m256i other_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other + j));
+        __m256i equal = _mm256_cmpeq_epi32(document_block, other_block);
+        for (int r = 1; r < 8; ++r) {
+            other_block = _mm256_permutevar8x32_epi32(other_block, rotate);
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(document_block, other_block));
+        }
+        found_mask |= static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(equal)));
+        const int document_max = documents[i + 7];
+        const int other_max = other[j + 7];
+        if (document_max <= other_max) {
+            // запись без ветвлений: позиция пишется всегда, счётчик растёт только для отбираемых
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                positions[position_count] = static_cast<uint32_t>(i + bit);
+                position_count += ((found_mask >> bit) & 1u) ^ (KEEP_FOUND ? 0u : 1u);
+            }
+            i += 8;
+            found_mask = 0;
+        }
+        if (other_max <= document_max) {
+            j += 8;
+        }
+    }
+    // хвост: совпадения текущего блока документов с уже пройденными элементами other лежат в found_mask
+    for (; i < count; ++i) {
+        while (j < other_count && other[j] < documents[i]) {
+            ++j;
+        }
+        const bool found = (found_mask & 1u) || (j < other_count && other[j] == documents[i]);
+        found_mask >>= 1;
+        if (found == KEEP_FOUND) {
+            positions[position_count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return position_count;
+}
+
+#endif
+
+using SelectPositionsFunction = size_t (*)(const int*, size_t, const int*, size_t, uint32_t*);
+
+template <bool KEEP_FOUND>
+SelectPositionsFunction SelectKernel() {
+#ifdef SEARCH_SERVER_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return SelectPositionsAvx2<KEEP_FOUND>;
+    }
+#endif
+    return SelectPositionsScalar<KEEP_FOUND>;
+}
+
+} // namespace
+
+size_t DifferenceSortedScalar(const int* documents, size_t count, const int* excluded, size_t excluded_count,
+                              uint32_t* kept_positions) {
+    return SelectPositionsScalar<false>(documents, count, excluded, excluded_count, kept_positions);
+}
+
+size_t DifferenceSorted(const int* documents, size_t count, const int* excluded, size_t excluded_count,
+                        uint32_t* kept_positions) {
+    static const SelectPositionsFunction difference_sorted = SelectKernel<false>();
+    return difference_sorted(documents, count, excluded, excluded_count, kept_positions);
+}
+
+size_t IntersectSortedScalar(const int* documents, size_t count, const int* other, size_t other_count,
+                             uint32_t* found_positions) {
+    return SelectPositionsScalar<true>(documents, count, other, other_count, found_positions);
+}
+
+size_t IntersectSorted(const int* documents, size_t count, const int* other, size_t other_count,
+                       uint32_t* found_positions) {
+    static const SelectPositionsFunction intersect_sorted = SelectKernel<true>();
+    return intersect_sorted(documents, count, other, other_count, found_positions);
+}
\ No newline at end of file
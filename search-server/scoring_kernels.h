@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Вычислительные ядра обхода списков документов.
+
+// scores[documents[i]] += term_freqs[i] * inverse_document_freq, matched[documents[i]] = 1.
+// Номера документов в одном списке не повторяются
+void AccumulateScores(const int* documents, const double* term_freqs, size_t count,
+                      double inverse_document_freq, double* scores, uint8_t* matched);
+
+// позиции тех элементов documents, которых нет в excluded; оба массива отсортированы по возрастанию.
+// Записывает позиции в kept_positions (нужно место под count элементов), возвращает их количество.
+// Версия для AVX2 выбирается во время выполнения по возможностям процессора, результат совпадает со скалярной
+size_t DifferenceSorted(const int* documents, size_t count, const int* excluded, size_t excluded_count,
+                        uint32_t* kept_positions);
+
+// скалярная версия - запасной вариант и эталон для сравнения
+size_t DifferenceSortedScalar(const int* documents, size_t count, const int* excluded, size_t excluded_count,
+                              uint32_t* kept_positions);
+
+// позиции тех элементов documents, которые есть и в other; оба массива отсортированы по возрастанию.
+// Контракт и выбор версии - как у DifferenceSorted
+size_t IntersectSorted(const int* documents, size_t count, const int* other, size_t other_count,
+                       uint32_t* found_positions);
+
+size_t IntersectSortedScalar(const int* documents, size_t count, const int* other, size_t other_count,
+                             uint32_t* found_positions);
\ No newline at end of file
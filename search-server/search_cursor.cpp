@@ -0,0 +1,41 @@
+#include "search_cursor.h"
+
+#include <algorithm>
+#include "top_documents.h"
+
+namespace {
+
+// для кучи "меньше" значит "менее релевантный", тогда на вершине лучший документ
+bool IsLessRelevant(const Document& lhs, const Document& rhs) {
+    return IsMoreRelevant(rhs, lhs);
+}
+
+} // namespace
+
+SearchCursor::SearchCursor(std::vector<Document> documents)
+        : heap_(std::move(documents)) {
+    std::make_heap(heap_.begin(), heap_.end(), IsLessRelevant);
+}
+
+std::vector<Document> SearchCursor::GetPage(size_t page_index, size_t page_size) {
+    // сравнение с частным вместо произведения page_index * page_size, которое может переполниться
+    if (page_size == 0 || page_index > size() / page_size) {
+        return {};
+    }
+    const size_t first = page_index * page_size;
+    const size_t last = first + std::min(page_size, size() - first);
+    SortPrefix(last);
+    return {sorted_.begin() + first, sorted_.begin() + last};
+}
+
+size_t SearchCursor::size() const {
+    return sorted_.size() + heap_.size();
+}
+
+void SearchCursor::SortPrefix(size_t count) {
+    while (sorted_.size() < count) {
+        std::pop_heap(heap_.begin(), heap_.end(), IsLessRelevant);
+        sorted_.push_back(heap_.back());
+        heap_.pop_back();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "document.h"
+
+// постраничная выдача результатов запроса любой глубины. Все подходящие документы оцениваются
+// один раз при открытии курсора (SearchServer::OpenCursor), но не сортируются: остаток хранится
+// кучей, и каждая страница извлекает из неё только свои документы - O(размер страницы * log N)
+// вместо повторного поиска и сортировки всей выдачи. Уже выданные страницы запоминаются,
+// так что к ним можно вернуться. Результаты - снимок индекса на момент открытия курсора
+class SearchCursor {
+public:
+    explicit SearchCursor(std::vector<Document> documents);
+
+    // страница page_index (с нуля) по page_size документов в порядке FindTopDocuments;
+    // за последней страницей - пустой список
+    std::vector<Document> GetPage(size_t page_index, size_t page_size);
+
+    // всего найденных документов
+    size_t size() const;
+
+private:
+    // начало выдачи, уже упорядоченное
+    std::vector<Document> sorted_;
+    // остальные документы - куча, на вершине которой самый релевантный
+    std::vector<Document> heap_;
+
+    void SortPrefix(size_t count);
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "search_profiler.h"
+
+#include <algorithm>
+
+namespace {
+
+struct StageCounters {
+    std::atomic<uint64_t> sample_count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+};
+
+std::array<StageCounters, SearchProfiler::STAGE_COUNT> stage_counters;
+
+struct PruningCounters {
+    std::atomic<uint64_t> query_count{0};
+    std::atomic<uint64_t> candidate_count{0};
+    std::atomic<uint64_t> pruned_count{0};
+    std::atomic<uint64_t> scored_count{0};
+};
+
+PruningCounters pruning_counters;
+
+} // namespace
+
+void SearchProfiler::Enable(uint32_t sample_period) {
+    sample_period_.store(sample_period, std::memory_order_relaxed);
+}
+
+void SearchProfiler::Disable() {
+    Enable(0);
+}
+
+void SearchProfiler::Record(SearchStage stage, std::chrono::nanoseconds duration) {
+    StageCounters& counters = stage_counters[static_cast<size_t>(stage)];
+    const uint64_t duration_ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+    counters.sample_count.fetch_add(1, std::memory_order_relaxed);
+    counters.total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    uint64_t max_ns = counters.max_ns.load(std::memory_order_relaxed);
+    while (max_ns < duration_ns
+           && !counters.max_ns.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+    }
+}
+
+SearchProfiler::StageStats SearchProfiler::GetStats(SearchStage stage) {
+    const StageCounters& counters = stage_counters[static_cast<size_t>(stage)];
+    StageStats stats;
+    stats.sample_count = counters.sample_count.load(std::memory_order_relaxed);
+    stats.total_duration = std::chrono::nanoseconds(counters.total_ns.load(std::memory_order_relaxed));
+    stats.max_duration = std::chrono::nanoseconds(counters.max_ns.load(std::memory_order_relaxed));
+    return stats;
+}
+
+void SearchProfiler::RecordPruning(const PruningStats& stats) {
+    pruning_counters.query_count.fetch_add(stats.query_count, std::memory_order_relaxed);
+    pruning_counters.candidate_count.fetch_add(stats.candidate_count, std::memory_order_relaxed);
+    pruning_counters.pruned_count.fetch_add(stats.pruned_count, std::memory_order_relaxed);
+    pruning_counters.scored_count.fetch_add(stats.scored_count, std::memory_order_relaxed);
+}
+
+SearchProfiler::PruningStats SearchProfiler::GetPruningStats() {
+    PruningStats stats;
+    stats.query_count = pruning_counters.query_count.load(std::memory_order_relaxed);
+    stats.candidate_count = pruning_counters.candidate_count.load(std::memory_order_relaxed);
+    stats.pruned_count = pruning_counters.pruned_count.load(std::memory_order_relaxed);
+    stats.scored_count = pruning_counters.scored_count.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SearchProfiler::Reset() {
+    for (StageCounters& counters : stage_counters) {
+        counters.sample_count.store(0, std::memory_order_relaxed);
+        counters.total_ns.store(0, std::memory_order_relaxed);
+        counters.max_ns.store(0, std::memory_order_relaxed);
+    }
+    pruning_counters.query_count.store(0, std::memory_order_relaxed);
+    pruning_counters.candidate_count.store(0, std::memory_order_relaxed);
+    pruning_counters.pruned_count.store(0, std::memory_order_relaxed);
+    pruning_counters.scored_count.store(0, std::memory_order_relaxed);
+}
+
+void SearchProfiler::PrintStats(std::ostream& out) {
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        const SearchStage stage = static_cast<SearchStage>(i);
+        const StageStats stats = GetStats(stage);
+        const double mean_us = stats.sample_count == 0
+                               ? 0.0
+                               : stats.total_duration.count() / 1000.0 / stats.sample_count;
+        out << GetSearchStageName(stage) << ": " << stats.sample_count << " samples, mean " << mean_us
+            << " us, max " << stats.max_duration.count() / 1000.0 << " us" << std::endl;
+    }
+    const PruningStats pruning = GetPruningStats();
+    if (pruning.query_count > 0) {
+        const double query_count = static_cast<double>(pruning.query_count);
+        out << "pruning: " << pruning.query_count << " queries, per query " << pruning.candidate_count / query_count
+            << " candidates, " << pruning.pruned_count / query_count << " pruned, "
+            << pruning.scored_count / query_count << " scored" << std::endl;
+    }
+}
+
+const char* GetSearchStageName(SearchStage stage) {
+    switch (stage) {
+        case SearchStage::PARSE:
+            return "parse";
+        case SearchStage::SCAN:
+            return "scan";
+        case SearchStage::FILTER:
+            return "filter";
+        case SearchStage::SORT:
+            return "sort";
+        case SearchStage::MATCH:
+            return "match";
+    }
+    return "unknown";
+}
\ No newline at end of file
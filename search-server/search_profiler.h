@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "log_duration.h"
+
+// стадии поиска. Стадии вкладываются: SCAN - весь отбор документов по спискам слов, вместе с FILTER
+// (отдельный проход отбора по минус-словам и предикату, где он есть) и SORT (упорядочивание топа).
+// В обходе с отсечением предикат проверяется по ходу обхода и входит только в SCAN
+enum class SearchStage {
+    PARSE,
+    SCAN,
+    FILTER,
+    SORT,
+    MATCH,
+};
+
+// выборочный замер стадий поиска в работающем сервере. Выключен по умолчанию, и тогда таймер стадии
+// стоит одну атомарную загрузку; включённый замеряет каждый sample_period-й проход стадии в каждом потоке.
+// С SEARCH_SERVER_NO_PROFILING таймеры не компилируются вовсе
+class SearchProfiler {
+public:
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(SearchStage::MATCH) + 1;
+
+    struct StageStats {
+        uint64_t sample_count = 0;
+        std::chrono::nanoseconds total_duration{0};
+        std::chrono::nanoseconds max_duration{0};
+    };
+
+    // sample_period == 0 выключает замер
+    static void Enable(uint32_t sample_period = 1);
+    static void Disable();
+
+    static uint32_t GetSamplePeriod() {
+        return sample_period_.load(std::memory_order_relaxed);
+    }
+
+    static void Record(SearchStage stage, std::chrono::nanoseconds duration);
+
+    static StageStats GetStats(SearchStage stage);
+
+    // счётчики обхода с отсечением MaxScore: документы-кандидаты из существенных списков, отсечённые
+    // по оценке сверху и подсчитанные до конца (прочие кандидаты отброшены минус-словами или предикатом).
+    // Пока замер включён, копятся по каждому запросу, а не по выборке
+    struct PruningStats {
+        uint64_t query_count = 0;
+        uint64_t candidate_count = 0;
+        uint64_t pruned_count = 0;
+        uint64_t scored_count = 0;
+    };
+
+    static void RecordPruning(const PruningStats& stats);
+    static PruningStats GetPruningStats();
+
+    static void Reset();
+
+    // по строке на стадию: число замеров, среднее и максимальное время; затем счётчики отсечения
+    static void PrintStats(std::ostream& out = std::cerr);
+
+private:
+    static inline std::atomic<uint32_t> sample_period_{0};
+};
+
+const char* GetSearchStageName(SearchStage stage);
+
+// замеряет время жизни объекта как проход стадии, если проход попал в выборку
+class StageTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StageTimer(SearchStage stage)
+            : stage_(stage) {
+        const uint32_t sample_period = SearchProfiler::GetSamplePeriod();
+        if (sample_period == 0) {
+            return;
+        }
+        thread_local std::array<uint32_t, SearchProfiler::STAGE_COUNT> pass_counts{};
+        uint32_t& pass_count = pass_counts[static_cast<size_t>(stage)];
+        if (++pass_count >= sample_period) {
+            pass_count = 0;
+            is_sampled_ = true;
+            start_time_ = Clock::now();
+        }
+    }
+
+    ~StageTimer() {
+        if (is_sampled_) {
+            SearchProfiler::Record(stage_, Clock::now() - start_time_);
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    SearchStage stage_;
+    bool is_sampled_ = false;
+    Clock::time_point start_time_;
+};
+
+#ifdef SEARCH_SERVER_NO_PROFILING
+#define PROFILE_SEARCH_STAGE(stage)
+#else
+#define PROFILE_SEARCH_STAGE(stage) StageTimer UNIQUE_VAR_NAME_PROFILE(stage)
+#endif
\ No newline at end of file
@@ -1,110 +1,559 @@
 #include "search_server.h"
 
+using namespace std;
+
 // функция добавления слов поискового запроса (без стоп-слов) в documents_
 //Метод AddDocument выбрасывет исключение invalid_argument в следующих ситуациях:
-void SearchServer::AddDocument(int document_id, const string& document, DocumentStatus status,
+void SearchServer::AddDocument(int document_id, string_view document, DocumentStatus status,
                  const vector<int>& ratings) {
-    if ((document_id < 0) || documents_.count(document_id)) {//Попытка добавить документ с отрицательным id;
+    if (document_id_to_index_.count(document_id)){//Попытка добавить документ c id ранее добавленного документа;
+        throw invalid_argument("repeat document id");
+    }
+    AddDocument(PrepareDocument(document_id, document, status, ratings));
+}
+
+SearchServer::PreparedDocument SearchServer::PrepareDocument(int document_id, string_view document,
+                                                             DocumentStatus status, const vector<int>& ratings) const {
+    if (document_id < 0) {//Попытка добавить документ с отрицательным id;
         throw invalid_argument("Document id less then zero");
     }
-    if (documents_.count(document_id)){//Попытка добавить документ c id ранее добавленного документа;
+    const vector<string_view> words = SplitIntoWordsNoStop(document);
+    const double inv_word_count = 1.0 / words.size();
+    map<string_view, double> word_freqs;
+    for (const string_view word : words) {
+        word_freqs[word] += inv_word_count;
+    }
+    return {document_id, ComputeAverageRating(ratings), status, WordFrequencies(word_freqs.begin(), word_freqs.end()),
+            static_cast<int>(words.size())};
+}
+
+void SearchServer::AddDocument(const PreparedDocument& document) {
+    if (document_id_to_index_.count(document.id)){//Попытка добавить документ c id ранее добавленного документа;
         throw invalid_argument("repeat document id");
     }
-    const vector<string> words = SplitIntoWordsNoStop(document);
-    const double inv_word_count = 1.0 / words.size();
-    for (const string& word : words) {
-        word_to_document_freqs_[word][document_id] += inv_word_count;
+    const int document_index = AppendDocument(document.id, document.rating, document.status, document.word_count);
+    WordFrequencies& document_word_freqs = documents_[document_index].word_freqs;
+    document_word_freqs.reserve(document.word_freqs.size());
+    for (const auto& [word, term_freq] : document.word_freqs) {
+        auto term_it = word_to_term_id_.find(word);
+        if (term_it == word_to_term_id_.end()) {
+            // ключ словаря должен ссылаться на собственную копию слова, а не на текст документа
+            term_it = word_to_term_id_.emplace(words_.emplace_back(word), static_cast<int>(postings_.size())).first;
+            postings_.emplace_back();
+        }
+        AppendPosting(postings_[term_it->second], document_index, term_freq, document.word_count);
+        document_word_freqs.emplace_back(term_it->first, term_freq);
+    }
+    generation_.Advance();
+}
+
+vector<SearchServer::PreparedDocument> SearchServer::PrepareDocuments(
+        const execution::sequenced_policy&, const vector<DocumentToAdd>& documents) const {
+    vector<PreparedDocument> prepared_documents;
+    prepared_documents.reserve(documents.size());
+    for (const DocumentToAdd& document : documents) {
+        prepared_documents.push_back(PrepareDocument(document.id, document.text, document.status, document.ratings));
+    }
+    return prepared_documents;
+}
+
+vector<SearchServer::PreparedDocument> SearchServer::PrepareDocuments(
+        const execution::parallel_policy&, const vector<DocumentToAdd>& documents) const {
+    vector<PreparedDocument> prepared_documents(documents.size());
+    // исключение, вылетевшее из параллельного алгоритма, завершает программу, поэтому ошибки собираются вручную
+    vector<exception_ptr> errors(documents.size());
+    transform(execution::par, documents.begin(), documents.end(), prepared_documents.begin(),
+              [this, &documents, &errors](const DocumentToAdd& document) {
+        try {
+            return PrepareDocument(document.id, document.text, document.status, document.ratings);
+        } catch (...) {
+            errors[&document - documents.data()] = current_exception();
+            return PreparedDocument{};
+        }
+    });
+    for (const exception_ptr& error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    return prepared_documents;
+}
+
+void SearchServer::AddDocuments(const vector<DocumentToAdd>& documents) {
+    AddDocuments(execution::seq, documents);
+}
+
+void SearchServer::AddDocuments(const execution::sequenced_policy&, const vector<DocumentToAdd>& documents) {
+    AddPreparedDocuments(PrepareDocuments(execution::seq, documents));
+}
+
+void SearchServer::AddDocuments(const execution::parallel_policy&, const vector<DocumentToAdd>& documents) {
+    AddPreparedDocuments(PrepareDocuments(execution::par, documents));
+}
+
+void SearchServer::AddPreparedDocuments(const vector<PreparedDocument>& documents) {
+    set<int> batch_ids;
+    for (const PreparedDocument& document : documents) {
+        if (document_id_to_index_.count(document.id) || !batch_ids.insert(document.id).second) {
+            throw invalid_argument("repeat document id");
+        }
+    }
+    const size_t document_count = documents_.size() + documents.size();
+    documents_.reserve(document_count);
+    document_attributes_.ids.reserve(document_count);
+    document_attributes_.ratings.reserve(document_count);
+    document_attributes_.statuses.reserve(document_count);
+    for (const PreparedDocument& document : documents) {
+        AddDocument(document);
     }
-    documents_.emplace(document_id, DocumentData{ComputeAverageRating(ratings), status});
-    document_ids.push_back(document_id);
-    //return 0;
 }
 
-vector<Document>  SearchServer::FindTopDocuments(const string& raw_query, DocumentStatus status) const{ //Если тут задать статус по умолчанию, то FindTopDocuments(const string& raw_query) будет не нужен
+void SearchServer::AddDocumentsFrom(const SearchServer& source) {
+    vector<uint8_t> is_live(source.documents_.size());
+    for (const auto& [document_id, source_index] : source.document_id_to_index_) {
+        if (document_id_to_index_.count(document_id)) {
+            throw invalid_argument("repeat document id");
+        }
+        is_live[source_index] = 1;
+    }
+    // номер документа в source -> номер здесь; порядок номеров сохраняется, поэтому
+    // списки документов source дописываются в конец списков без сортировки
+    vector<int> index_map(source.documents_.size());
+    for (size_t source_index = 0; source_index < source.documents_.size(); ++source_index) {
+        if (!is_live[source_index]) {
+            continue;
+        }
+        const DocumentData& document = source.documents_[source_index];
+        index_map[source_index] = AppendDocument(source.document_attributes_.ids[source_index],
+                                                 source.document_attributes_.ratings[source_index],
+                                                 source.document_attributes_.statuses[source_index],
+                                                 document.word_count);
+        documents_.back().word_freqs.reserve(document.word_freqs.size());
+    }
+    // слова обходятся по алфавиту, чтобы прямой индекс каждого документа сразу получился отсортированным
+    vector<pair<string_view, int>> source_terms(source.word_to_term_id_.begin(), source.word_to_term_id_.end());
+    sort(source_terms.begin(), source_terms.end());
+    PostingsBuffer buffer;
+    for (const auto& [word, source_term_id] : source_terms) {
+        const PostingList& source_list = source.postings_[source_term_id];
+        if (source_list.size() == 0) {
+            continue;
+        }
+        auto term_it = word_to_term_id_.find(word);
+        if (term_it == word_to_term_id_.end()) {
+            term_it = word_to_term_id_.emplace(words_.emplace_back(word), static_cast<int>(postings_.size())).first;
+            postings_.emplace_back();
+        }
+        PostingList& posting_list = postings_[term_it->second];
+        const PostingsView postings = source.ViewPostings(source_list, buffer);
+        for (size_t i = 0; i < postings.size; ++i) {
+            const int document_index = index_map[postings.documents[i]];
+            DocumentData& document = documents_[document_index];
+            if (posting_list_layout_ == PostingListLayout::PLAIN) {
+                posting_list.documents.push_back(document_index);
+                posting_list.term_freqs.push_back(postings.term_freqs[i]);
+            } else {
+                posting_list.compressed.Append(document_index,
+                                               static_cast<uint32_t>(lround(postings.term_freqs[i] * document.word_count)));
+            }
+            document.word_freqs.emplace_back(term_it->first, postings.term_freqs[i]);
+        }
+        posting_list.log_document_freq = log(posting_list.size() * 1.0);
+        posting_list.max_term_freq = max(posting_list.max_term_freq, source_list.max_term_freq);
+    }
+    generation_.Advance();
+}
+
+vector<Document>  SearchServer::FindTopDocuments(string_view raw_query, DocumentStatus status, size_t top_k) const{ //Если тут задать статус по умолчанию, то FindTopDocuments(string_view raw_query) будет не нужен
     if (IsValidWord(raw_query) == false){
         throw invalid_argument("Invalid word in FindTopDocument function");
     }
-    auto predict = [status](int document_id, DocumentStatus doc_status, int rating) {
-        return doc_status == status;
-    };
-    return FindTopDocuments(raw_query, predict);
+    return FindTopDocuments(raw_query, StatusFilter{status}, top_k);
+}
+
+SearchCursor SearchServer::OpenCursor(string_view raw_query, DocumentStatus status) const {
+    return OpenCursor(raw_query, StatusFilter{status});
+}
+
+void SearchServer::CollectCorpusStatistics(string_view raw_query, CorpusStatistics& statistics) const {
+    if (IsValidWord(raw_query) == false){
+        throw invalid_argument("Invalid word in CollectCorpusStatistics function");
+    }
+    ScopedQueryContext context;
+    ParseQuery(raw_query, context->words, context->query);
+    statistics.document_count += GetDocumentCount();
+    for (const string_view word : context->query.plus_words) {
+        const PostingList* posting_list = FindPostingList(word);
+        statistics.document_freqs[word] += posting_list == nullptr ? 0 : static_cast<int>(posting_list->size());
+    }
+}
+
+void SearchServer::ExcludeFromCorpusStatistics(int document_id, CorpusStatistics& statistics) const {
+    if (!HasDocument(document_id)) {
+        return;
+    }
+    const WordFrequencies& word_freqs = GetWordFrequencies(document_id);
+    --statistics.document_count;
+    for (auto& [word, document_freq] : statistics.document_freqs) {
+        if (!FindDocumentWord(word_freqs, word).empty()) {
+            --document_freq;
+        }
+    }
 }
 
 //Метод должен возвращать количество документов в поисковой системе.
 int SearchServer::GetDocumentCount() const {
-    return documents_.size();
+    return document_id_to_index_.size();
+}
+
+bool SearchServer::HasDocument(int document_id) const {
+    return document_id_to_index_.count(document_id) > 0;
 }
 
 //В первом элементе кортежа верните все плюс-слова запроса, содержащиеся в документе.
 // Слова не должны дублироваться. Отсортированы по возрастанию.
 // Если нет пересечений по плюс-словам или есть минус-слово, вектор слов вернуть пустым.
-tuple<vector<string>, DocumentStatus> SearchServer::MatchDocument(const string& raw_query,
+tuple<vector<string>, DocumentStatus> SearchServer::MatchDocument(string_view raw_query,
                                                     int document_id)
 // Если документ не соответствует запросу(нет пересечений по плюс - словам
 // или есть минус - слово), вектор слов нужно вернуть пустым.
 const {
+    const auto [matched_words, status] = MatchDocument(execution::seq, raw_query, document_id);
+    return {vector<string>(matched_words.begin(), matched_words.end()), status};
+}
+
+tuple<vector<string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::sequenced_policy&,
+                                                                       string_view raw_query, int document_id) const {
     if (IsValidWord(raw_query) == false){
         throw invalid_argument("Invalid word in MatchDocument function");
     }
+    PROFILE_SEARCH_STAGE(SearchStage::MATCH);
+    const int document_index = document_id_to_index_.at(document_id);
+    const WordFrequencies& word_freqs = documents_[document_index].word_freqs;
+    const DocumentStatus status = document_attributes_.statuses[document_index];
+    ScopedQueryContext context;
+    SplitQuery(raw_query, context->words, context->query);
+    return {MatchDocumentWords(word_freqs, context->query), status};
+}
+
+vector<string_view> SearchServer::MatchDocumentWords(const WordFrequencies& word_freqs, const Query& query) {
+    vector<string_view> matched_words;
+    if (any_of(query.minus_words.begin(), query.minus_words.end(), [&word_freqs](string_view word) {
+            return !FindDocumentWord(word_freqs, word).empty();
+        })) {
+        return matched_words;
+    }
+    for (const string_view word : query.plus_words) {
+        const string_view document_word = FindDocumentWord(word_freqs, word);
+        if (!document_word.empty()) {
+            matched_words.push_back(document_word);
+        }
+    }
+    SortUniqueWords(matched_words);
+    return matched_words;
+}
+
+string_view SearchServer::FindDocumentWord(const WordFrequencies& word_freqs, string_view word) {
+    const auto word_it = lower_bound(word_freqs.begin(), word_freqs.end(), word,
+                                     [](const auto& word_freq, string_view value) {
+        return word_freq.first < value;
+    });
+    if (word_it == word_freqs.end() || word_it->first != word) {
+        return {};
+    }
+    return word_it->first;
+}
+
+tuple<vector<string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::parallel_policy&,
+                                                                       string_view raw_query, int document_id) const {
+    if (IsValidWord(raw_query) == false){
+        throw invalid_argument("Invalid word in MatchDocument function");
+    }
+    PROFILE_SEARCH_STAGE(SearchStage::MATCH);
+    const int document_index = document_id_to_index_.at(document_id);
+    const WordFrequencies& word_freqs = documents_[document_index].word_freqs;
+    const DocumentStatus status = document_attributes_.statuses[document_index];
+    ScopedQueryContext context;
+    SplitQuery(raw_query, context->words, context->query);
+    const Query& query = context->query;
+    if (query.plus_words.size() + query.minus_words.size() < PARALLEL_MATCH_MIN_WORDS) {
+        return {MatchDocumentWords(word_freqs, query), status};
+    }
+    if (any_of(execution::par, query.minus_words.begin(), query.minus_words.end(), [&word_freqs](string_view word) {
+            return !FindDocumentWord(word_freqs, word).empty();
+        })) {
+        return {vector<string_view>{}, status};
+    }
+    vector<string_view> matched_words(query.plus_words.size());
+    transform(execution::par, query.plus_words.begin(), query.plus_words.end(), matched_words.begin(),
+              [&word_freqs](string_view word) {
+        return FindDocumentWord(word_freqs, word);
+    });
+    matched_words.erase(remove(matched_words.begin(), matched_words.end(), string_view{}), matched_words.end());
+    SortUniqueWords(matched_words);
+    return {matched_words, status};
+}
+
+string SearchServer::NormalizeQuery(string_view raw_query) const {
+    if (IsValidWord(raw_query) == false){
+        throw invalid_argument("Invalid word in NormalizeQuery function");
+    }
     const Query query = ParseQuery(raw_query);
-    vector<string> matched_words;
-    for (const string& word : query.plus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
+    string normalized_query;
+    for (const string_view word : query.plus_words) {
+        normalized_query.append(word);
+        normalized_query += ' ';
+    }
+    for (const string_view word : query.minus_words) {
+        normalized_query += '-';
+        normalized_query.append(word);
+        normalized_query += ' ';
+    }
+    return normalized_query;
+}
+
+uint64_t SearchServer::GetGeneration() const {
+    return generation_.Load();
+}
+
+int SearchServer::AppendDocument(int document_id, int rating, DocumentStatus status, int word_count) {
+    const int document_index = static_cast<int>(documents_.size());
+    documents_.push_back({word_count, {}});
+    document_attributes_.ids.push_back(document_id);
+    document_attributes_.ratings.push_back(rating);
+    document_attributes_.statuses.push_back(status);
+    document_id_to_index_.emplace(document_id, document_index);
+    document_ids.insert(document_id);
+    return document_index;
+}
+
+uint64_t SearchServer::NextGeneration() {
+    static atomic<uint64_t> last_generation = 0;
+    return ++last_generation;
+}
+
+set<int>::const_iterator SearchServer::begin() const {
+    return document_ids.begin();
+}
+
+set<int>::const_iterator SearchServer::end() const {
+    return document_ids.end();
+}
+
+const SearchServer::WordFrequencies& SearchServer::GetWordFrequencies(int document_id) const {
+    static const WordFrequencies empty_word_freqs;
+    const auto index_it = document_id_to_index_.find(document_id);
+    if (index_it == document_id_to_index_.end()) {
+        return empty_word_freqs;
+    }
+    return documents_[index_it->second].word_freqs;
+}
+
+void SearchServer::RemoveDocument(int document_id) {
+    RemoveDocument(execution::seq, document_id);
+}
+
+void SearchServer::RemoveDocument(const execution::sequenced_policy&, int document_id) {
+    const auto index_it = document_id_to_index_.find(document_id);
+    if (index_it == document_id_to_index_.end()) {
+        return;
+    }
+    const int document_index = index_it->second;
+    DocumentData& document_data = documents_[document_index];
+    for (const auto& [word, _] : document_data.word_freqs) {
+        ErasePosting(postings_[word_to_term_id_.at(word)], document_index);
+    }
+    document_data.word_freqs = {};
+    document_id_to_index_.erase(index_it);
+    document_ids.erase(document_id);
+    generation_.Advance();
+}
+
+void SearchServer::RemoveDocument(const execution::parallel_policy&, int document_id) {
+    const auto index_it = document_id_to_index_.find(document_id);
+    if (index_it == document_id_to_index_.end()) {
+        return;
+    }
+    const int document_index = index_it->second;
+    DocumentData& document_data = documents_[document_index];
+    vector<PostingList*> posting_lists(document_data.word_freqs.size());
+    transform(execution::par, document_data.word_freqs.begin(), document_data.word_freqs.end(), posting_lists.begin(),
+              [this](const auto& word_freq) {
+        return &postings_[word_to_term_id_.at(word_freq.first)];
+    });
+    // у каждого слова свой список документов, поэтому задачи не пересекаются по данным
+    for_each(execution::par, posting_lists.begin(), posting_lists.end(), [document_index](PostingList* posting_list) {
+        ErasePosting(*posting_list, document_index);
+    });
+    document_data.word_freqs = {};
+    document_id_to_index_.erase(index_it);
+    document_ids.erase(document_id);
+    generation_.Advance();
+}
+
+void SearchServer::SetPostingListLayout(PostingListLayout layout) {
+    if (layout == posting_list_layout_) {
+        return;
+    }
+    PostingsBuffer buffer;
+    for (PostingList& posting_list : postings_) {
+        if (layout == PostingListLayout::COMPRESSED) {
+            for (size_t i = 0; i < posting_list.documents.size(); ++i) {
+                const int document_index = posting_list.documents[i];
+                const int word_count = documents_[document_index].word_count;
+                posting_list.compressed.Append(document_index,
+                                               static_cast<uint32_t>(lround(posting_list.term_freqs[i] * word_count)));
+            }
+            posting_list.documents = {};
+            posting_list.term_freqs = {};
+        } else {
+            const PostingsView postings = ViewPostings(posting_list, buffer);
+            posting_list.documents.assign(postings.documents, postings.documents + postings.size);
+            posting_list.term_freqs.assign(postings.term_freqs, postings.term_freqs + postings.size);
+            posting_list.compressed = {};
         }
-        if (word_to_document_freqs_.at(word).count(document_id)) {
-            matched_words.push_back(word);
+    }
+    posting_list_layout_ = layout;
+}
+
+SearchServer::PostingListLayout SearchServer::GetPostingListLayout() const {
+    return posting_list_layout_;
+}
+
+bool SearchServer::IsStopWord(string_view word) const {
+    return stop_word_filter_.Contains(word);
+}
+
+const SearchServer::PostingList* SearchServer::FindPostingList(string_view word) const {
+    const auto term_it = word_to_term_id_.find(word);
+    if (term_it == word_to_term_id_.end() || postings_[term_it->second].size() == 0) {
+        return nullptr;
+    }
+    return &postings_[term_it->second];
+}
+
+void SearchServer::FindPostingLists(const vector<string_view>& words, vector<const PostingList*>& posting_lists) const {
+    posting_lists.clear();
+    for (const string_view word : words) {
+        if (const PostingList* posting_list = FindPostingList(word)) {
+            posting_lists.push_back(posting_list);
         }
     }
-    for (const string& word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
+}
+
+void SearchServer::FindPlusPostingLists(QueryContext& context, const CorpusStatistics* statistics) const {
+    context.plus_lists.clear();
+    context.plus_idfs.clear();
+    const double log_document_count = statistics == nullptr ? ComputeLogDocumentCount()
+                                                            : log(statistics->document_count * 1.0);
+    for (const string_view word : context.query.plus_words) {
+        const PostingList* posting_list = FindPostingList(word);
+        if (posting_list == nullptr) {
+            continue;
+        }
+        if (statistics == nullptr) {
+            context.plus_lists.push_back(posting_list);
+            context.plus_idfs.push_back(ComputeWordInverseDocumentFreq(*posting_list, log_document_count));
             continue;
         }
-        if (word_to_document_freqs_.at(word).count(document_id)) {
-            matched_words.clear();
-            break;
+        // слово есть только у документов, уже исключённых из корпуса: в корпусе его нет
+        const int document_freq = statistics->document_freqs.at(word);
+        if (document_freq == 0) {
+            continue;
         }
+        context.plus_lists.push_back(posting_list);
+        // ln(df) считается так же, как log_document_freq списка, чтобы IDF совпадала до бита
+        context.plus_idfs.push_back(log_document_count - log(document_freq * 1.0));
     }
-    auto result = tuple{matched_words, documents_.at(document_id).status};
-    return result;
 }
 
-int SearchServer::GetDocumentId(const int index) const {
-    return document_ids.at(index);
+void SearchServer::ErasePosting(PostingList& posting_list, int document_index) {
+    if (!posting_list.compressed.empty()) {
+        posting_list.compressed.Erase(document_index);
+        posting_list.log_document_freq = log(posting_list.compressed.size() * 1.0);
+        return;
+    }
+    const auto document_it = lower_bound(posting_list.documents.begin(), posting_list.documents.end(), document_index);
+    const auto offset = document_it - posting_list.documents.begin();
+    posting_list.documents.erase(document_it);
+    posting_list.term_freqs.erase(posting_list.term_freqs.begin() + offset);
+    posting_list.log_document_freq = log(posting_list.documents.size() * 1.0);
 }
 
-bool SearchServer::IsStopWord(const string& word) const {
-    return stop_words_.count(word) > 0;
+void SearchServer::AppendPosting(PostingList& posting_list, int document_index, double term_freq,
+                                 int word_count) const {
+    if (posting_list_layout_ == PostingListLayout::COMPRESSED) {
+        posting_list.compressed.Append(document_index, static_cast<uint32_t>(lround(term_freq * word_count)));
+    } else {
+        posting_list.documents.push_back(document_index);
+        posting_list.term_freqs.push_back(term_freq);
+    }
+    posting_list.log_document_freq = log(posting_list.size() * 1.0);
+    posting_list.max_term_freq = max(posting_list.max_term_freq, term_freq);
+}
+
+bool SearchServer::ContainsDocument(const PostingList& posting_list, int document_index) {
+    if (!posting_list.compressed.empty()) {
+        return posting_list.compressed.Contains(document_index);
+    }
+    return binary_search(posting_list.documents.begin(), posting_list.documents.end(), document_index);
+}
+
+SearchServer::PostingsView SearchServer::ViewPostings(const PostingList& posting_list, PostingsBuffer& buffer) const {
+    if (posting_list.compressed.empty()) {
+        return {posting_list.documents.data(), posting_list.term_freqs.data(), posting_list.documents.size()};
+    }
+    posting_list.compressed.Decode(buffer.documents, buffer.term_counts);
+    buffer.term_freqs.resize(buffer.documents.size());
+    for (size_t i = 0; i < buffer.documents.size(); ++i) {
+        buffer.term_freqs[i] = ComputeTermFreq(buffer.term_counts[i], documents_[buffer.documents[i]].word_count);
+    }
+    return {buffer.documents.data(), buffer.term_freqs.data(), buffer.documents.size()};
+}
+
+SearchServer::PostingsView SearchServer::ViewDocuments(const PostingList& posting_list, PostingsBuffer& buffer) {
+    if (posting_list.compressed.empty()) {
+        return {posting_list.documents.data(), nullptr, posting_list.documents.size()};
+    }
+    posting_list.compressed.Decode(buffer.documents, buffer.term_counts);
+    return {buffer.documents.data(), nullptr, buffer.documents.size()};
+}
+
+double SearchServer::ComputeTermFreq(uint32_t term_count, int word_count) {
+    const double inv_word_count = 1.0 / word_count;
+    double term_freq = 0.0;
+    for (uint32_t i = 0; i < term_count; ++i) {
+        term_freq += inv_word_count;
+    }
+    return term_freq;
 }
 
 // функция считывания слов поискового запроса и удаления из него стоп-слов (считывание плюс-слов)
-vector<string> SearchServer::SplitIntoWordsNoStop(const string& text) const {
-    vector<string> words;
-    for (const string& word : SplitIntoWords(text)) {
-        if (IsValidWord(word) == false) {//Наличие недопустимых символов (с кодами от 0 до 31) в тексте добавляемого документа.
-            throw invalid_argument("Invalid word");
-        }
-        if (!IsStopWord(word)) {
-            words.push_back(word);
-        }
+vector<string_view> SearchServer::SplitIntoWordsNoStop(string_view text) const {
+    vector<string_view> words;
+    // разбиение и проверка символов - один проход по тексту
+    if (!SplitIntoValidWords(text, words)) {//Наличие недопустимых символов (с кодами от 0 до 31) в тексте добавляемого документа.
+        throw invalid_argument("Invalid word");
     }
+    words.erase(remove_if(words.begin(), words.end(), [this](string_view word) {
+        return IsStopWord(word);
+    }), words.end());
     return words;
 }
 
 int SearchServer::ComputeAverageRating(const vector<int>& ratings) {
     // Use std::accumulate вместо цикла
     if (ratings.empty()) return 0;
-    return accumulate(begin(ratings), end(ratings), 0)
+    return accumulate(ratings.begin(), ratings.end(), 0)
            / static_cast<int>(ratings.size());
 }
 
 // обработка минус-слов запроса
-SearchServer::QueryWord SearchServer::ParseQueryWord(string text) const {
-    QueryWord result;
+SearchServer::QueryWord SearchServer::ParseQueryWord(string_view text) const {
     bool is_minus = false;
     if (text[0] == '-') {
         is_minus = true;
-        text = text.substr(1);
+        text.remove_prefix(1);
     }
     if (IsValidWord(text) == false) {//Наличие недопустимых символов (с кодами от 0 до 31) в тексте добавляемого документа.
         throw invalid_argument("Invalid word. Words ASCII 0-31.");
@@ -115,30 +564,78 @@ SearchServer::QueryWord SearchServer::ParseQueryWord(string text) const {
     return { text, is_minus, IsStopWord(text) };
 }
 
-SearchServer::Query SearchServer::ParseQuery(const string& text) const {
+SearchServer::Query SearchServer::ParseQuery(string_view text) const {
     Query query;
-    for (const string& word : SplitIntoWords(text)) {
+    vector<string_view> words;
+    ParseQuery(text, words, query);
+    return query;
+}
+
+void SearchServer::ParseQuery(string_view text, vector<string_view>& words, Query& query) const {
+    PROFILE_SEARCH_STAGE(SearchStage::PARSE);
+    SplitQuery(text, words, query);
+    SortUniqueWords(query.plus_words);
+    SortUniqueWords(query.minus_words);
+}
+
+void SearchServer::SplitQuery(string_view text, vector<string_view>& words, Query& query) const {
+    SplitIntoWords(text, words);
+    query.plus_words.clear();
+    query.minus_words.clear();
+    query.plus_words.reserve(words.size());
+    for (const string_view word : words) {
         const QueryWord query_word = ParseQueryWord(word);
         if (!query_word.is_stop) {
             if (query_word.is_minus) {
-                query.minus_words.insert(query_word.data);
+                query.minus_words.push_back(query_word.data);
             } else {
-                query.plus_words.insert(query_word.data);
+                query.plus_words.push_back(query_word.data);
             }
         }
     }
-    return query;
+}
+
+void SearchServer::SortUniqueWords(vector<string_view>& words) {
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+}
+
+SearchServer::PostingsBuffer& SearchServer::QueryContext::GetBuffer(size_t index) {
+    if (buffers.size() <= index) {
+        buffers.resize(index + 1);
+    }
+    return buffers[index];
+}
+
+SearchServer::ScopedQueryContext::ScopedQueryContext() {
+    thread_local ThreadState thread_state;
+    if (thread_state.is_busy) {
+        own_context_ = make_unique<QueryContext>();
+        context_ = own_context_.get();
+    } else {
+        thread_state.is_busy = true;
+        thread_state_ = &thread_state;
+        context_ = &thread_state.context;
+    }
+}
+
+SearchServer::ScopedQueryContext::~ScopedQueryContext() {
+    if (thread_state_ != nullptr) {
+        thread_state_->is_busy = false;
+    }
 }
 
 // Existence required
 // вычисляем IDF - делим количество документов
 // где встречается слово на количество всех документов и берём нат.логарифм
-double SearchServer::ComputeWordInverseDocumentFreq(const string& word) const {
-    return log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(word).size());
+double SearchServer::ComputeLogDocumentCount() const {
+    return log(GetDocumentCount() * 1.0);
 }
 
-bool SearchServer::IsValidWord(const string& word) {//проверка слова на наличие спецсимволов
-    return none_of(word.begin(), word.end(), [](char c) {
-        return c >= '\0' && c < ' ';
-    });
+double SearchServer::ComputeWordInverseDocumentFreq(const PostingList& posting_list, double log_document_count) {
+    return log_document_count - posting_list.log_document_freq;
+}
+
+bool SearchServer::IsValidWord(string_view word) {//проверка слова на наличие спецсимволов
+    return HasNoControlCharacters(word);
 }
\ No newline at end of file
@@ -1,16 +1,34 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include "compressed_posting_list.h"
+#include <cstdint>
 #include "document.h"
+#include "document_filters.h"
+#include <deque>
+#include <execution>
+#include <iterator>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
 #include <numeric>
 #include "read_input_functions.h"
+#include "scoring_kernels.h"
+#include "search_cursor.h"
+#include "search_profiler.h"
+#include "stop_word_filter.h"
 #include "string_processing.h"
+#include "top_documents.h"
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 // механизм поиска
@@ -21,86 +39,481 @@ public:
     template <typename StringContainer>
     explicit SearchServer(const StringContainer& stop_words);
     explicit SearchServer(const std::string& stop_words_text)
+            : SearchServer(std::string_view(stop_words_text))
+    {
+    }
+    explicit SearchServer(std::string_view stop_words_text)
             : SearchServer(
             SplitIntoWords(stop_words_text))  // Invoke delegating constructor from string container
     {
     }
+
+    // словарь и прямой индекс ссылаются на собственное хранилище слов (words_), поэтому
+    // копирование дало бы висячие ссылки; перемещение deque сохраняет адреса элементов
+    SearchServer(const SearchServer&) = delete;
+    SearchServer& operator=(const SearchServer&) = delete;
+    SearchServer(SearchServer&&) = default;
+    SearchServer& operator=(SearchServer&&) = default;
 // функция добавления слов поискового запроса (без стоп-слов) в documents_
 //Метод AddDocument выбрасывет исключение invalid_argument в следующих ситуациях:
-    void AddDocument(int document_id, const std::string& document, DocumentStatus status,
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status,
                      const std::vector<int>& ratings);
 
+    // частоты слов документа: пары (слово, TF), отсортированные по слову, без повторов
+    using WordFrequencies = std::vector<std::pair<std::string_view, double>>;
+
+    // документ, разобранный на слова, но ещё не добавленный в индекс; слова ссылаются на исходный текст
+    struct PreparedDocument {
+        int id = 0;
+        int rating = 0;
+        DocumentStatus status = DocumentStatus::ACTUAL;
+        WordFrequencies word_freqs;
+        // число слов документа без стоп-слов, знаменатель TF
+        int word_count = 0;
+    };
+
+    // AddDocument в два шага. Разбор не меняет индекс, поэтому его можно выполнять в любом потоке
+    // одновременно с поиском и с другими разборами; сама вставка короткая и требует исключительного доступа.
+    // Исходный текст документа должен быть жив до конца вставки
+    PreparedDocument PrepareDocument(int document_id, std::string_view document, DocumentStatus status,
+                                     const std::vector<int>& ratings) const;
+    void AddDocument(const PreparedDocument& document);
+
+    // документ для пакетного добавления
+    struct DocumentToAdd {
+        int id;
+        std::string_view text;
+        DocumentStatus status;
+        std::vector<int> ratings;
+    };
+
+    // разбор пакета документов; при ошибке в любом из них выбрасывается исключение первого по порядку
+    std::vector<PreparedDocument> PrepareDocuments(const std::execution::sequenced_policy&,
+                                                   const std::vector<DocumentToAdd>& documents) const;
+    std::vector<PreparedDocument> PrepareDocuments(const std::execution::parallel_policy&,
+                                                   const std::vector<DocumentToAdd>& documents) const;
+
+    // пакетное добавление: с std::execution::par тексты разбираются параллельно, затем документы
+    // вставляются в индекс одним проходом в порядке следования. Если хотя бы один документ некорректен
+    // или его id уже занят, исключение выбрасывается до изменения индекса
+    void AddDocuments(const std::vector<DocumentToAdd>& documents);
+    void AddDocuments(const std::execution::sequenced_policy&, const std::vector<DocumentToAdd>& documents);
+    void AddDocuments(const std::execution::parallel_policy&, const std::vector<DocumentToAdd>& documents);
+
+    // переносит все документы source, дописывая списки документов его слов целиком: без разбора текстов
+    // и без поиска в словаре каждого слова каждого документа. Если id какого-то документа source
+    // уже занят, исключение invalid_argument выбрасывается до изменения индекса
+    void AddDocumentsFrom(const SearchServer& source);
+
     // Фильтрация документов должна производиться до отсечения топа из пяти штук.
-    // функция вывода 5 наиболее релевантных результатов из всех найденных
+    // функция вывода top_k (по умолчанию 5) наиболее релевантных результатов из всех найденных
+
+    std::vector<Document>  FindTopDocuments(std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL,
+                                            size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // predict - функция (id, статус, рейтинг); фильтры из document_filters.h проверяются без её вызова
+    template<typename predicate>
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, predicate predict,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // те же методы с политикой выполнения: std::execution::par распределяет обход
+    // списков документов плюс-слов и удаление минус-слов по ядрам
+    template<typename ExecutionPolicy, typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                           DocumentStatus status = DocumentStatus::ACTUAL,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    template<typename ExecutionPolicy, typename predicate,
+             typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, predicate predict,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // курсор для постраничного обхода всей выдачи запроса, без ограничения top_k (search_cursor.h)
+    SearchCursor OpenCursor(std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL) const;
+
+    template<typename predicate>
+    SearchCursor OpenCursor(std::string_view raw_query, predicate predict) const;
 
-    std::vector<Document>  FindTopDocuments(const std::string& raw_query, DocumentStatus status = DocumentStatus::ACTUAL) const;
+    // статистика корпуса, разделённого между несколькими серверами (например, сегментами индекса):
+    // число документов во всех частях и число документов с каждым плюс-словом запроса.
+    // Ключи - срезы текста запроса, поэтому он должен жить, пока используется статистика
+    struct CorpusStatistics {
+        int document_count = 0;
+        std::map<std::string_view, int> document_freqs;
+    };
+
+    // добавляет в statistics документы этого сервера и их числа со словами запроса
+    void CollectCorpusStatistics(std::string_view raw_query, CorpusStatistics& statistics) const;
+
+    // вычитает из statistics документ этого сервера, который уже исключён из корпуса, но ещё лежит в сервере
+    void ExcludeFromCorpusStatistics(int document_id, CorpusStatistics& statistics) const;
 
+    // поиск по документам этого сервера с IDF, посчитанной по statistics всего корпуса (собранной для того же
+    // запроса): релевантности совпадают до бита с поиском по одному серверу, в котором лежит весь корпус
     template<typename predicate>
-    std::vector<Document> FindTopDocuments(const std::string& raw_query, predicate predict) const;
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, const CorpusStatistics& statistics,
+                                           predicate predict, size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
 
 //Метод должен возвращать количество документов в поисковой системе.
     int GetDocumentCount() const;
 
+    bool HasDocument(int document_id) const;
+
 //В первом элементе кортежа верните все плюс-слова запроса, содержащиеся в документе.
 // Слова не должны дублироваться. Отсортированы по возрастанию.
 // Если нет пересечений по плюс-словам или есть минус-слово, вектор слов вернуть пустым.
-    std::tuple<std::vector<std::string>, DocumentStatus> MatchDocument(const std::string& raw_query,
+    std::tuple<std::vector<std::string>, DocumentStatus> MatchDocument(std::string_view raw_query,
                                                         int document_id)
     // Если документ не соответствует запросу(нет пересечений по плюс - словам
     // или есть минус - слово), вектор слов нужно вернуть пустым.
     const;
 
-    int GetDocumentId(const int index) const;
+    // то же по прямому индексу документа: слова запроса ищутся среди отсортированных слов самого документа,
+    // без словаря и списков документов. Срезы указывают на хранилище слов сервера и живут вместе с ним.
+    // С std::execution::par запрос от PARALLEL_MATCH_MIN_WORDS слов проверяется на нескольких ядрах
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::execution::sequenced_policy&,
+                                                                            std::string_view raw_query,
+                                                                            int document_id) const;
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::execution::parallel_policy&,
+                                                                            std::string_view raw_query,
+                                                                            int document_id) const;
+
+    // канонический вид запроса: плюс-слова по алфавиту, затем минус-слова с '-', без стоп-слов и повторов.
+    // Запросы с одинаковым каноническим видом дают одинаковый результат; некорректный запрос -
+    // исключение invalid_argument, как в FindTopDocuments
+    std::string NormalizeQuery(std::string_view raw_query) const;
+
+    // версия индекса: меняется при каждом добавлении и удалении документа. Номера выдаёт общий для всех
+    // серверов счётчик, поэтому версия не повторяется и после замены сервера другим (перемещением, загрузкой снимка)
+    uint64_t GetGeneration() const;
+
+    // обход id всех документов по возрастанию
+    std::set<int>::const_iterator begin() const;
+    std::set<int>::const_iterator end() const;
+
+    // частоты слов документа; для несуществующего документа - пустой список
+    const WordFrequencies& GetWordFrequencies(int document_id) const;
+
+    // удаление документа: обходит только слова самого документа (по его прямому индексу),
+    // а не весь словарь. Параллельная версия чистит списки документов разных слов одновременно
+    void RemoveDocument(int document_id);
+    void RemoveDocument(const std::execution::sequenced_policy&, int document_id);
+    void RemoveDocument(const std::execution::parallel_policy&, int document_id);
+
+    // размещение списков документов слов в памяти. PLAIN - массивы номеров документов и частот;
+    // COMPRESSED - разности номеров и числа вхождений слова в формате varint с указателями пропуска
+    // (compressed_posting_list.h): в несколько раз компактнее, но поиск распаковывает списки слов запроса.
+    // Переключение перестраивает все списки
+    enum class PostingListLayout { PLAIN, COMPRESSED };
+    void SetPostingListLayout(PostingListLayout layout);
+    PostingListLayout GetPostingListLayout() const;
 
 private:
+    // снимок индекса на диске (index_snapshot.h) читает и восстанавливает внутренние структуры напрямую
+    friend void SaveSnapshot(const SearchServer& search_server, const std::string& path);
+    friend SearchServer LoadSnapshot(const std::string& path);
+
+    // id, рейтинг и статус документа хранятся отдельно, в столбцах document_attributes_
     struct DocumentData {
-        int rating;
-        DocumentStatus status;
+        int word_count;
+        // прямой индекс: слова документа и их частоты; слова ссылаются на words_.
+        // Плоский массив вместо std::map: без узла на каждое слово документа
+        WordFrequencies word_freqs;
+    };
+
+    // список документов одного слова: параллельные массивы внутренних номеров документов
+    // (по возрастанию) и частот слова в них, либо, при сжатом размещении, compressed
+    // с числами вхождений вместо частот (частота восстанавливается по word_count документа)
+    struct PostingList {
+        std::vector<int> documents;
+        std::vector<double> term_freqs;
+        CompressedPostingList compressed;
+        // ln(число документов со словом); пересчитывается только при изменении списка,
+        // чтобы при поиске IDF слова сводился к вычитанию
+        double log_document_freq = 0.0;
+        // наибольшая TF слова по списку - оценка сверху для отсечения при поиске. Растёт при добавлении
+        // и не уменьшается при удалении: после удаления остаётся верной, хотя и менее точной, оценкой
+        double max_term_freq = 0.0;
+
+        size_t size() const {
+            return documents.size() + compressed.size();
+        }
+    };
+
+    // список документов слова в виде непрерывных массивов, как его обходят ядра подсчёта.
+    // Для несжатого списка указывает прямо в него, сжатый распаковывается в PostingsBuffer
+    struct PostingsView {
+        const int* documents;
+        const double* term_freqs;
+        size_t size;
+    };
+
+    struct PostingsBuffer {
+        std::vector<int> documents;
+        std::vector<uint32_t> term_counts;
+        std::vector<double> term_freqs;
+    };
+
+    std::set<std::string, std::less<>> stop_words_;
+    // те же стоп-слова для проверки слов при разборе
+    StopWordFilter stop_word_filter_;
+    // словарь: слово -> плотный номер терма, по номеру лежит его список документов.
+    // Единственная копия каждого слова хранится в words_ (deque не перемещает элементы
+    // при добавлении), ключи словаря ссылаются на неё
+    std::deque<std::string> words_;
+    std::unordered_map<std::string_view, int> word_to_term_id_;
+    std::vector<PostingList> postings_;
+    // документы по внутреннему номеру; номера выдаются подряд в порядке добавления,
+    // поэтому новый документ всегда дописывается в конец списков. Номера удалённых
+    // документов повторно не используются
+    std::vector<DocumentData> documents_;
+    // атрибуты документов по внутреннему номеру, отдельными плотными массивами: фильтр по статусу
+    // или рейтингу (document_filters.h) читает только свой массив, а не всю запись документа
+    struct DocumentAttributes {
+        std::vector<int> ids;
+        std::vector<int> ratings;
+        std::vector<DocumentStatus> statuses;
     };
+    DocumentAttributes document_attributes_;
+    std::map<int, int> document_id_to_index_;
+    std::set<int> document_ids; //для хранения айдишников
+    PostingListLayout posting_list_layout_ = PostingListLayout::PLAIN;
+
+    static uint64_t NextGeneration();
+
+    // версия индекса. Атомарная: GetGeneration читают без блокировки (QueryCache - до поиска), пока другой
+    // поток может менять индекс под своей блокировкой. Перемещение сервера переносит значение
+    class Generation {
+    public:
+        Generation()
+                : value_(NextGeneration()) {
+        }
+
+        Generation(Generation&& other) noexcept
+                : value_(other.Load()) {
+        }
+
+        Generation& operator=(Generation&& other) noexcept {
+            value_.store(other.Load(), std::memory_order_release);
+            return *this;
+        }
+
+        uint64_t Load() const {
+            return value_.load(std::memory_order_acquire);
+        }
+
+        void Advance() {
+            value_.store(NextGeneration(), std::memory_order_release);
+        }
+
+    private:
+        std::atomic<uint64_t> value_;
+    };
+
+    Generation generation_;
+
+    // дописывает документ без слов в конец documents_ и столбцов атрибутов; возвращает его внутренний номер
+    int AppendDocument(int document_id, int rating, DocumentStatus status, int word_count);
+
+    // проверка документа предикатом поиска. Фильтры из document_filters.h распознаются при компиляции
+    // и читают один столбец атрибутов; любой другой предикат получает id, статус и рейтинг
+    template<typename DocPredicate>
+    bool IsDocumentAccepted(DocPredicate& doc_pred, int document_index) const;
+
+    // документ для выдачи: id и рейтинг из столбцов атрибутов
+    Document MakeDocument(int document_index, double relevance) const {
+        return {document_attributes_.ids[document_index], relevance, document_attributes_.ratings[document_index]};
+    }
+
+    bool IsStopWord(std::string_view word) const;
 
-    std::set<std::string> stop_words_;
-    std::map<std::string, std::map<int, double>> word_to_document_freqs_;
-    std::map<int, DocumentData> documents_;
-    std::vector<int> document_ids; //для хранения айдишников
+    // список документов слова или nullptr, если слово не встречается ни в одном документе
+    const PostingList* FindPostingList(std::string_view word) const;
+    // списки документов слов, которые встречаются в индексе
+    void FindPostingLists(const std::vector<std::string_view>& words,
+                          std::vector<const PostingList*>& posting_lists) const;
 
-    bool IsStopWord(const std::string& word) const;
+    // убирает документ из списка документов слова
+    static void ErasePosting(PostingList& posting_list, int document_index);
+
+    static bool ContainsDocument(const PostingList& posting_list, int document_index);
+
+    // номера и частоты (ViewPostings) или только номера документов списка (ViewDocuments)
+    PostingsView ViewPostings(const PostingList& posting_list, PostingsBuffer& buffer) const;
+    static PostingsView ViewDocuments(const PostingList& posting_list, PostingsBuffer& buffer);
+
+    // TF слова, встреченного term_count раз, считается так же, как при разборе документа:
+    // сложением 1 / word_count, чтобы сжатый список давал те же релевантности до последнего бита
+    static double ComputeTermFreq(uint32_t term_count, int word_count);
+
+    // вставка разобранного пакета после проверки, что ни один id не занят и не повторяется
+    void AddPreparedDocuments(const std::vector<PreparedDocument>& documents);
 
 // функция считывания слов поискового запроса и удаления из него стоп-слов (считывание плюс-слов)
-    std::vector<std::string> SplitIntoWordsNoStop(const std::string& text) const;
+    std::vector<std::string_view> SplitIntoWordsNoStop(std::string_view text) const;
 
     static int ComputeAverageRating(const std::vector<int>& ratings);
 
     struct QueryWord {
-        std::string data;
+        std::string_view data;
         bool is_minus;
         bool is_stop;
     };
 
     // обработка минус-слов запроса
-    QueryWord ParseQueryWord(std::string text) const;
+    QueryWord ParseQueryWord(std::string_view text) const;
 
+    // слова запроса - срезы строки запроса, отсортированы и без повторов
     struct Query {
-        std::set<std::string> plus_words;
-        std::set<std::string> minus_words;
+        std::vector<std::string_view> plus_words;
+        std::vector<std::string_view> minus_words;
+    };
+
+    Query ParseQuery(std::string_view text) const;
+    // то же в готовые буферы: words - разбиение текста, query - результат
+    void ParseQuery(std::string_view text, std::vector<std::string_view>& words, Query& query) const;
+    // разбор без упорядочивания: слова запроса в порядке текста, возможно с повторами
+    void SplitQuery(std::string_view text, std::vector<std::string_view>& words, Query& query) const;
+    static void SortUniqueWords(std::vector<std::string_view>& words);
+
+    // слово прямого индекса документа, равное word, или пустой срез, если его в документе нет
+    static std::string_view FindDocumentWord(const WordFrequencies& word_freqs, std::string_view word);
+    // плюс-слова запроса (разобранного SplitQuery), которые есть в документе, срезами его прямого индекса,
+    // по возрастанию и без повторов; пусто, если в документе есть минус-слово. Запрос не упорядочивается:
+    // слова ищутся в документе двоичным поиском, и сортируются только найденные
+    static std::vector<std::string_view> MatchDocumentWords(const WordFrequencies& word_freqs, const Query& query);
+
+    // слово запроса для обхода с отсечением: позиция в его списке документов и оценка вклада сверху
+    struct PruningTerm {
+        PostingsView postings;
+        size_t position;
+        double inverse_document_freq;
+        double max_score;
+        size_t query_index;
+    };
+
+    // рабочие буферы одного поиска. Каждый поток переиспользует свой экземпляр от запроса к запросу:
+    // буферы сохраняют ёмкость, и когда она набрана, поиск не выделяет память, кроме вектора результатов
+    struct QueryContext {
+        std::vector<std::string_view> words;
+        Query query;
+        std::vector<const PostingList*> plus_lists;
+        // IDF слов из plus_lists
+        std::vector<double> plus_idfs;
+        std::vector<const PostingList*> minus_lists;
+        // распакованные сжатые списки, по буферу на слово запроса
+        std::vector<PostingsBuffer> buffers;
+        // обход с отсечением
+        std::vector<PruningTerm> terms;
+        std::vector<PruningTerm> minus_terms;
+        std::vector<CompressedPostingList::Cursor> minus_cursors;
+        std::vector<double> max_score_sums;
+        std::vector<double> contributions;
+        // плотный подсчёт: между поисками массивы нулевые, после поиска обнуляются только затронутые элементы
+        std::vector<double> scores;
+        std::vector<uint8_t> matched;
+        // одно плюс-слово
+        std::vector<int> excluded;
+        std::vector<int> merged;
+        std::vector<uint32_t> kept_positions;
+
+        // буфер для i-го списка запроса
+        PostingsBuffer& GetBuffer(size_t index);
     };
 
-    Query ParseQuery(const std::string& text) const;
+    // буферы поиска текущего потока на время одного поиска. Вложенный поиск в том же потоке
+    // (например, из предиката) получает собственный временный экземпляр
+    class ScopedQueryContext {
+    public:
+        ScopedQueryContext();
+        ~ScopedQueryContext();
+        ScopedQueryContext(const ScopedQueryContext&) = delete;
+        ScopedQueryContext& operator=(const ScopedQueryContext&) = delete;
+
+        QueryContext& operator*() const {
+            return *context_;
+        }
+
+        QueryContext* operator->() const {
+            return context_;
+        }
+
+    private:
+        struct ThreadState {
+            QueryContext context;
+            bool is_busy = false;
+        };
+
+        ThreadState* thread_state_ = nullptr;
+        std::unique_ptr<QueryContext> own_context_;
+        QueryContext* context_;
+    };
 
     // Existence required
     // вычисляем IDF - делим количество документов
-    // где встречается слово на количество всех документов и берём нат.логарифм
-    double ComputeWordInverseDocumentFreq(const std::string& word) const;
+    // где встречается слово на количество всех документов и берём нат.логарифм:
+    // ln(N / df) = ln(N) - ln(df), ln(N) считается один раз на запрос, ln(df) хранится в списке
+    double ComputeLogDocumentCount() const;
+    static double ComputeWordInverseDocumentFreq(const PostingList& posting_list, double log_document_count);
 
-// функция вывода ВСЕХ найденных результатов по релевантности по формуле TF-IDF
+    // списки документов плюс-слов запроса из context.query с их IDF - по этому серверу
+    // или, если statistics не nullptr, по всему корпусу
+    void FindPlusPostingLists(QueryContext& context, const CorpusStatistics* statistics) const;
+
+    // добавляет документ в конец списка или убирает его, поддерживая log_document_freq
+    void AppendPosting(PostingList& posting_list, int document_index, double term_freq, int word_count) const;
+
+// функция подсчёта релевантности ВСЕХ найденных документов по формуле TF-IDF;
+// документы сразу проходят через отбор top_k лучших и возвращаются отсортированными
     template<typename DocPredicate>
-    std::vector<Document> FindAllDocuments(const Query& query, DocPredicate doc_pred) const;
+    std::vector<Document> FindAllDocuments(const std::execution::sequenced_policy&, QueryContext& context,
+                                           const CorpusStatistics* statistics, DocPredicate doc_pred,
+                                           size_t top_k) const;
+    template<typename DocPredicate>
+    std::vector<Document> FindAllDocuments(const std::execution::parallel_policy&, QueryContext& context,
+                                           const CorpusStatistics* statistics, DocPredicate doc_pred,
+                                           size_t top_k) const;
+
+    // плотный массив релевантностей выгоднее обхода с отсечением, когда плюс-слова дают хотя бы
+    // 1/DENSE_SCORES_MIN_SHARE от числа документов в индексе, а топ длиннее PRUNING_MAX_TOP_K
+    static constexpr size_t DENSE_SCORES_MIN_SHARE = 16;
+    static constexpr size_t PRUNING_MAX_TOP_K = 100;
+
+    // запас на погрешность округления при сравнении оценки сверху с границей отбора
+    static constexpr double PRUNING_SLACK = 1e-9;
 
-    static bool IsValidWord(const std::string& word);
+    // более короткий запрос MatchDocument с std::execution::par проверяется в одном потоке:
+    // раздача задач по ядрам дороже самой проверки
+    static constexpr size_t PARALLEL_MATCH_MIN_WORDS = 256;
+
+    // параллельный FindAllDocuments не дробит индекс на диапазоны короче этого числа документов
+    static constexpr size_t PARALLEL_SCAN_MIN_DOCUMENTS = 4096;
+
+    // списки слов запроса и IDF берутся из context.plus_lists, context.plus_idfs и context.minus_lists
+    template<typename DocPredicate>
+    std::vector<Document> FindSingleWordDocuments(QueryContext& context, DocPredicate doc_pred, size_t top_k) const;
+    template<typename DocPredicate>
+    std::vector<Document> FindDocumentsWithPruning(QueryContext& context, DocPredicate doc_pred, size_t top_k) const;
+    // передаёт все найденные документы в sink.Add (TopDocuments или DocumentCollector) по возрастанию номера
+    template<typename DocPredicate, typename DocumentSink>
+    void CollectDocumentsWithDenseScores(QueryContext& context, DocPredicate doc_pred, DocumentSink& sink) const;
+
+    // все найденные документы без отбора и сортировки
+    struct DocumentCollector {
+        std::vector<Document> documents;
+
+        void Add(const Document& document) {
+            documents.push_back(document);
+        }
+    };
+
+    static bool IsValidWord(std::string_view word);
 };
 
 template <typename StringContainer>
 SearchServer::SearchServer(const StringContainer& stop_words)
-        : stop_words_(MakeUniqueNonEmptyStrings(stop_words)) {
+        : stop_words_(MakeUniqueNonEmptyStrings(stop_words))
+        , stop_word_filter_(stop_words_) {
     //Конструктор класса SearchServer выбрасывать исключение
     // invalid_argument если любое из переданных стоп-слов содержит недопустимые символы
     for(const auto& stop_word: stop_words_){
@@ -111,54 +524,396 @@ SearchServer::SearchServer(const StringContainer& stop_words)
 }
 
 template<typename predicate>
-std::vector<Document> SearchServer::FindTopDocuments(const std::string& raw_query, predicate predict) const {
+std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query, predicate predict,
+                                                     size_t top_k) const {
+    return FindTopDocuments(std::execution::seq, raw_query, predict, top_k);
+}
+
+template<typename ExecutionPolicy, typename>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                     DocumentStatus status, size_t top_k) const {
+    return FindTopDocuments(policy, raw_query, StatusFilter{status}, top_k);
+}
+
+template<typename ExecutionPolicy, typename predicate, typename>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                     predicate predict, size_t top_k) const {
+    if (IsValidWord(raw_query) == false){
+        throw std::invalid_argument("Invalid word in FindTopDocument function");
+    }
+    ScopedQueryContext context;
+    ParseQuery(raw_query, context->words, context->query);
+    return FindAllDocuments(policy, *context, nullptr, predict, top_k);
+}
+
+template<typename predicate>
+std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query, const CorpusStatistics& statistics,
+                                                     predicate predict, size_t top_k) const {
     if (IsValidWord(raw_query) == false){
         throw std::invalid_argument("Invalid word in FindTopDocument function");
     }
-    const Query query = ParseQuery(raw_query);
-    auto matched_documents = FindAllDocuments(query, predict);
-    sort(matched_documents.begin(), matched_documents.end(),
-         [](const Document& lhs, const Document& rhs) {
-             if (abs(lhs.relevance - rhs.relevance) < std::numeric_limits<double>::epsilon()) { //Избавились от магических чисел через стандартный std::numeric_limits<double>::epsilon()
-                 return lhs.rating > rhs.rating;
-             } //else {  else не обязателен, т.к. используется return
-             return lhs.relevance > rhs.relevance;
-             //}
-         });
-    if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
-    }
-    return matched_documents;
+    ScopedQueryContext context;
+    ParseQuery(raw_query, context->words, context->query);
+    return FindAllDocuments(std::execution::seq, *context, &statistics, predict, top_k);
+}
+
+// плотный подсчёт годится для любого числа слов и не зависит от top_k, поэтому курсор собирает
+// через него всю выдачу; релевантности совпадают с FindTopDocuments до бита
+template<typename predicate>
+SearchCursor SearchServer::OpenCursor(std::string_view raw_query, predicate predict) const {
+    if (IsValidWord(raw_query) == false){
+        throw std::invalid_argument("Invalid word in OpenCursor function");
+    }
+    ScopedQueryContext context;
+    ParseQuery(raw_query, context->words, context->query);
+    FindPlusPostingLists(*context, nullptr);
+    FindPostingLists(context->query.minus_words, context->minus_lists);
+    DocumentCollector collector;
+    CollectDocumentsWithDenseScores(*context, predict, collector);
+    return SearchCursor(std::move(collector.documents));
+}
+
+template<typename DocPredicate>
+bool SearchServer::IsDocumentAccepted(DocPredicate& doc_pred, int document_index) const {
+    if constexpr (std::is_same_v<DocPredicate, StatusFilter>) {
+        return document_attributes_.statuses[document_index] == doc_pred.status;
+    } else if constexpr (std::is_same_v<DocPredicate, RatingAboveFilter>) {
+        return document_attributes_.ratings[document_index] > doc_pred.threshold;
+    } else if constexpr (std::is_same_v<DocPredicate, DocumentIdRangeFilter>) {
+        const int document_id = document_attributes_.ids[document_index];
+        return doc_pred.first_id <= document_id && document_id <= doc_pred.last_id;
+    } else {
+        return doc_pred(document_attributes_.ids[document_index], document_attributes_.statuses[document_index],
+                        document_attributes_.ratings[document_index]);
+    }
 }
 
 // функция вывода ВСЕХ найденных результатов по релевантности по формуле TF-IDF
 template<typename DocPredicate>
-std::vector<Document> SearchServer::FindAllDocuments(const Query& query, DocPredicate doc_pred) const {
-    std::map<int, double> document_to_relevance;
-    for (const std::string& word : query.plus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
+std::vector<Document> SearchServer::FindAllDocuments(const std::execution::sequenced_policy&, QueryContext& context,
+                                                     const CorpusStatistics* statistics, DocPredicate doc_pred,
+                                                     size_t top_k) const {
+    PROFILE_SEARCH_STAGE(SearchStage::SCAN);
+    FindPlusPostingLists(context, statistics);
+    FindPostingLists(context.query.minus_words, context.minus_lists);
+    size_t plus_posting_count = 0;
+    for (const PostingList* posting_list : context.plus_lists) {
+        plus_posting_count += posting_list->size();
+    }
+    if (context.plus_lists.size() == 1) {
+        return FindSingleWordDocuments(context, doc_pred, top_k);
+    }
+    // широкий запрос с длинным топом почти ничего не отсекает, и плотный массив релевантностей дешевле
+    if (plus_posting_count * DENSE_SCORES_MIN_SHARE >= documents_.size() && top_k > PRUNING_MAX_TOP_K) {
+        TopDocuments top_documents(top_k);
+        CollectDocumentsWithDenseScores(context, doc_pred, top_documents);
+        return top_documents.Extract();
+    }
+    return FindDocumentsWithPruning(context, doc_pred, top_k);
+}
+
+// одно плюс-слово: релевантность документа - просто TF * IDF, накопитель не нужен,
+// а минус-слова вычитаются из отсортированного списка документов
+template<typename DocPredicate>
+std::vector<Document> SearchServer::FindSingleWordDocuments(QueryContext& context, DocPredicate doc_pred,
+                                                            size_t top_k) const {
+    const PostingList& posting_list = *context.plus_lists.front();
+    std::vector<int>& excluded = context.excluded;
+    excluded.clear();
+    PostingsBuffer& buffer = context.GetBuffer(0);
+    std::vector<uint32_t>& kept_positions = context.kept_positions;
+    PostingsView postings;
+    size_t kept_count = 0;
+    {
+        PROFILE_SEARCH_STAGE(SearchStage::FILTER);
+        for (const PostingList* minus_list : context.minus_lists) {
+            const PostingsView minus_documents = ViewDocuments(*minus_list, buffer);
+            std::vector<int>& merged = context.merged;
+            merged.clear();
+            std::set_union(excluded.begin(), excluded.end(),
+                           minus_documents.documents, minus_documents.documents + minus_documents.size,
+                           std::back_inserter(merged));
+            excluded.swap(merged);
         }
-        const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-        for (const auto& [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-            const auto& document_info = documents_.at(document_id);
-            if (doc_pred(document_id, document_info.status, document_info.rating)) {
-                document_to_relevance[document_id] += term_freq * inverse_document_freq;
+        postings = ViewPostings(posting_list, buffer);
+        kept_positions.resize(postings.size);
+        kept_count = DifferenceSorted(postings.documents, postings.size,
+                                      excluded.data(), excluded.size(), kept_positions.data());
+    }
+    const double inverse_document_freq = context.plus_idfs.front();
+    TopDocuments top_documents(top_k);
+    for (size_t i = 0; i < kept_count; ++i) {
+        const uint32_t position = kept_positions[i];
+        const int document_index = postings.documents[position];
+        if (IsDocumentAccepted(doc_pred, document_index)) {
+            top_documents.Add(MakeDocument(document_index, postings.term_freqs[position] * inverse_document_freq));
+        }
+    }
+    return top_documents.Extract();
+}
+
+// широкий запрос с длинным топом: списки плюс-слов покрывают заметную долю индекса, и плотный массив
+// релевантностей по номерам документов дешевле обхода с отсечением. Предикат проверяется один раз на документ
+template<typename DocPredicate, typename DocumentSink>
+void SearchServer::CollectDocumentsWithDenseScores(QueryContext& context, DocPredicate doc_pred,
+                                                   DocumentSink& sink) const {
+    // массивы контекста общие для всех серверов потока и только растут; новые элементы нулевые
+    std::vector<double>& scores = context.scores;
+    std::vector<uint8_t>& matched = context.matched;
+    if (scores.size() < documents_.size()) {
+        scores.resize(documents_.size());
+        matched.resize(documents_.size());
+    }
+    PostingsBuffer& buffer = context.GetBuffer(0);
+    for (size_t i = 0; i < context.plus_lists.size(); ++i) {
+        const PostingsView postings = ViewPostings(*context.plus_lists[i], buffer);
+        AccumulateScores(postings.documents, postings.term_freqs, postings.size, context.plus_idfs[i],
+                         scores.data(), matched.data());
+    }
+    for (const PostingList* posting_list : context.minus_lists) {
+        const PostingsView minus_documents = ViewDocuments(*posting_list, buffer);
+        for (size_t i = 0; i < minus_documents.size; ++i) {
+            matched[minus_documents.documents[i]] = 0;
+            scores[minus_documents.documents[i]] = 0.0;
+        }
+    }
+    PROFILE_SEARCH_STAGE(SearchStage::FILTER);
+    size_t document_index = 0;
+    try {
+        for (; document_index < documents_.size(); ++document_index) {
+            if (!matched[document_index]) {
+                continue;
+            }
+            const double relevance = scores[document_index];
+            matched[document_index] = 0;
+            scores[document_index] = 0.0;
+            if (IsDocumentAccepted(doc_pred, static_cast<int>(document_index))) {
+                sink.Add(MakeDocument(static_cast<int>(document_index), relevance));
             }
         }
+    } catch (...) {
+        // исключение из предиката: непройденный хвост массивов всё равно должен остаться нулевым
+        std::fill(matched.begin() + document_index, matched.end(), 0);
+        std::fill(scores.begin() + document_index, scores.end(), 0.0);
+        throw;
+    }
+}
+
+// несколько плюс-слов: обход по документам с отсечением MaxScore. У каждого слова есть оценка сверху
+// его вклада (max_term_freq * IDF). Слова упорядочены по оценке; префикс слов с суммой оценок ниже
+// границы отбора (худшего из уже отобранных top_k) не может сам по себе вывести документ в топ, поэтому
+// кандидаты берутся только из остальных, "существенных" списков, а в несущественных документ
+// ищется двоичным поиском и лишь пока сумма набранного и оставшихся оценок достигает границы.
+// Документ отсекается, только если он заведомо не прошёл бы сравнение с худшим в TopDocuments,
+// а релевантность найденных складывается в порядке слов запроса, как при полном подсчёте,
+// поэтому результат совпадает с ним до бита, включая упорядочивание по рейтингу
+template<typename DocPredicate>
+std::vector<Document> SearchServer::FindDocumentsWithPruning(QueryContext& context, DocPredicate doc_pred,
+                                                             size_t top_k) const {
+    using Term = PruningTerm;
+    const std::vector<const PostingList*>& plus_lists = context.plus_lists;
+    const std::vector<const PostingList*>& minus_lists = context.minus_lists;
+    // буферы забираются из контекста в локальные переменные на время обхода и возвращаются в конце
+    std::vector<Term> terms = std::move(context.terms);
+    std::vector<Term> minus_terms = std::move(context.minus_terms);
+    std::vector<CompressedPostingList::Cursor> minus_cursors = std::move(context.minus_cursors);
+    std::vector<double> max_score_sums = std::move(context.max_score_sums);
+    std::vector<double> contributions = std::move(context.contributions);
+    terms.clear();
+    for (size_t i = 0; i < plus_lists.size(); ++i) {
+        const double inverse_document_freq = context.plus_idfs[i];
+        terms.push_back({ViewPostings(*plus_lists[i], context.GetBuffer(i)), 0, inverse_document_freq,
+                         plus_lists[i]->max_term_freq * inverse_document_freq, i});
     }
-    for (const std::string& word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
+    std::sort(terms.begin(), terms.end(), [](const Term& lhs, const Term& rhs) {
+        return lhs.max_score < rhs.max_score;
+    });
+    // max_score_sums[i] - сумма оценок слов 0..i
+    max_score_sums.resize(terms.size());
+    double max_score_sum = 0.0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        max_score_sum += terms[i].max_score;
+        max_score_sums[i] = max_score_sum;
+    }
+    // сжатые списки минус-слов не распаковываются: кандидаты идут по возрастанию,
+    // и курсор перескакивает блоки, где их нет
+    minus_terms.clear();
+    minus_cursors.clear();
+    for (size_t i = 0; i < minus_lists.size(); ++i) {
+        if (minus_lists[i]->compressed.empty()) {
+            minus_terms.push_back({ViewDocuments(*minus_lists[i], context.GetBuffer(plus_lists.size() + i)),
+                                   0, 0.0, 0.0, i});
+        } else {
+            minus_cursors.emplace_back(minus_lists[i]->compressed);
+        }
+    }
+    // продвигает позицию слова к первому документу не меньше заданного; true, если он и найден.
+    // Искомый документ обычно недалеко, поэтому шаг удваивается, а двоичный поиск идёт только по последнему шагу
+    const auto skip_to = [](Term& term, int document_index) {
+        const int* documents = term.postings.documents;
+        size_t low = term.position;
+        size_t step = 1;
+        while (low + step < term.postings.size && documents[low + step] < document_index) {
+            low += step;
+            step *= 2;
+        }
+        const size_t high = std::min(low + step + 1, term.postings.size);
+        term.position = std::lower_bound(documents + low, documents + high, document_index) - documents;
+        return term.position < term.postings.size && documents[term.position] == document_index;
+    };
+
+    contributions.resize(terms.size());
+    SearchProfiler::PruningStats pruning_stats;
+    TopDocuments top_documents(top_k);
+    double threshold = top_documents.GetThreshold();
+    size_t first_essential = 0;
+    while (first_essential < terms.size()) {
+        int document_index = std::numeric_limits<int>::max();
+        for (size_t i = first_essential; i < terms.size(); ++i) {
+            const Term& term = terms[i];
+            if (term.position < term.postings.size) {
+                document_index = std::min(document_index, term.postings.documents[term.position]);
+            }
+        }
+        if (document_index == std::numeric_limits<int>::max()) {
+            break;
+        }
+        ++pruning_stats.candidate_count;
+        // фильтр по атрибуту дешевле подсчёта, поэтому не прошедший его документ только пропускается
+        if constexpr (IS_ATTRIBUTE_FILTER<DocPredicate>) {
+            if (!IsDocumentAccepted(doc_pred, document_index)) {
+                for (size_t i = first_essential; i < terms.size(); ++i) {
+                    Term& term = terms[i];
+                    if (term.position < term.postings.size && term.postings.documents[term.position] == document_index) {
+                        ++term.position;
+                    }
+                }
+                continue;
+            }
+        }
+        std::fill(contributions.begin(), contributions.end(), 0.0);
+        double score = 0.0;
+        for (size_t i = first_essential; i < terms.size(); ++i) {
+            Term& term = terms[i];
+            if (term.position < term.postings.size && term.postings.documents[term.position] == document_index) {
+                const double contribution = term.postings.term_freqs[term.position] * term.inverse_document_freq;
+                contributions[term.query_index] = contribution;
+                score += contribution;
+                ++term.position;
+            }
+        }
+        bool is_pruned = false;
+        for (size_t i = first_essential; i-- > 0;) {
+            if (score + max_score_sums[i] + PRUNING_SLACK < threshold) {
+                is_pruned = true;
+                break;
+            }
+            Term& term = terms[i];
+            if (skip_to(term, document_index)) {
+                const double contribution = term.postings.term_freqs[term.position] * term.inverse_document_freq;
+                contributions[term.query_index] = contribution;
+                score += contribution;
+            }
+        }
+        pruning_stats.pruned_count += is_pruned;
+        if (is_pruned
+            || std::any_of(minus_terms.begin(), minus_terms.end(), [&](Term& term) {
+                   return skip_to(term, document_index);
+               })
+            || std::any_of(minus_cursors.begin(), minus_cursors.end(), [&](CompressedPostingList::Cursor& cursor) {
+                   return cursor.SkipTo(document_index);
+               })) {
+            continue;
+        }
+        if (!IS_ATTRIBUTE_FILTER<DocPredicate> && !IsDocumentAccepted(doc_pred, document_index)) {
             continue;
         }
-        for (const auto& [document_id, _] : word_to_document_freqs_.at(word)) {
-            document_to_relevance.erase(document_id);
+        const double relevance = std::accumulate(contributions.begin(), contributions.end(), 0.0);
+        ++pruning_stats.scored_count;
+        top_documents.Add(MakeDocument(document_index, relevance));
+        threshold = top_documents.GetThreshold();
+        while (first_essential < terms.size() && max_score_sums[first_essential] + PRUNING_SLACK < threshold) {
+            ++first_essential;
         }
     }
-    std::vector<Document> matched_documents;
-    for (const auto& [document_id, relevance] : document_to_relevance) {
-        matched_documents.push_back(
-                {document_id, relevance, documents_.at(document_id).rating});
+    context.terms = std::move(terms);
+    context.minus_terms = std::move(minus_terms);
+    context.minus_cursors = std::move(minus_cursors);
+    context.max_score_sums = std::move(max_score_sums);
+    context.contributions = std::move(contributions);
+#ifndef SEARCH_SERVER_NO_PROFILING
+    if (SearchProfiler::GetSamplePeriod() != 0) {
+        pruning_stats.query_count = 1;
+        SearchProfiler::RecordPruning(pruning_stats);
+    }
+#endif
+    return top_documents.Extract();
+}
+
+// параллельная версия: номера документов делятся на диапазоны, каждый диапазон считается в своей задаче
+// в собственном плотном массиве релевантностей, поэтому общих блокировок нет. Начало и конец диапазона
+// в списке слова находятся двоичным поиском. Вклады слов складываются в порядке запроса, как в
+// последовательной версии, а лучшие top_k каждого диапазона сливаются в общий топ
+template<typename DocPredicate>
+std::vector<Document> SearchServer::FindAllDocuments(const std::execution::parallel_policy&, QueryContext& context,
+                                                     const CorpusStatistics* statistics, DocPredicate doc_pred,
+                                                     size_t top_k) const {
+    PROFILE_SEARCH_STAGE(SearchStage::SCAN);
+    FindPlusPostingLists(context, statistics);
+    FindPostingLists(context.query.minus_words, context.minus_lists);
+    const std::vector<const PostingList*>& plus_lists = context.plus_lists;
+    const std::vector<const PostingList*>& minus_lists = context.minus_lists;
+    // сжатые списки распаковываются заранее, задачи диапазонов их только читают
+    std::vector<PostingsView> plus_postings;
+    std::vector<PostingsView> minus_documents;
+    context.GetBuffer(plus_lists.size() + minus_lists.size());
+    for (size_t i = 0; i < plus_lists.size(); ++i) {
+        plus_postings.push_back(ViewPostings(*plus_lists[i], context.GetBuffer(i)));
+    }
+    for (size_t i = 0; i < minus_lists.size(); ++i) {
+        minus_documents.push_back(ViewDocuments(*minus_lists[i], context.GetBuffer(plus_lists.size() + i)));
     }
-    return matched_documents;
+
+    const size_t document_count = documents_.size();
+    const size_t chunk_count = std::clamp<size_t>(document_count / PARALLEL_SCAN_MIN_DOCUMENTS, 1,
+                                                  std::max(1u, std::thread::hardware_concurrency()) * 4);
+    std::vector<size_t> chunks(chunk_count);
+    std::iota(chunks.begin(), chunks.end(), 0);
+    std::vector<std::vector<Document>> chunk_documents(chunk_count);
+    std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](const size_t chunk) {
+        const int first = static_cast<int>(document_count * chunk / chunk_count);
+        const int last = static_cast<int>(document_count * (chunk + 1) / chunk_count);
+        // позиции списка с номерами документов из [first, last)
+        const auto find_range = [first, last](const PostingsView& postings) {
+            const int* const end = postings.documents + postings.size;
+            return std::pair{std::lower_bound(postings.documents, end, first) - postings.documents,
+                             std::lower_bound(postings.documents, end, last) - postings.documents};
+        };
+        std::vector<double> scores(last - first);
+        std::vector<uint8_t> matched(last - first);
+        for (size_t i = 0; i < plus_postings.size(); ++i) {
+            const PostingsView& postings = plus_postings[i];
+            const double inverse_document_freq = context.plus_idfs[i];
+            const auto [range_begin, range_end] = find_range(postings);
+            for (auto position = range_begin; position < range_end; ++position) {
+                const int offset = postings.documents[position] - first;
+                scores[offset] += postings.term_freqs[position] * inverse_document_freq;
+                matched[offset] = 1;
+            }
+        }
+        for (const PostingsView& documents : minus_documents) {
+            const auto [range_begin, range_end] = find_range(documents);
+            for (auto position = range_begin; position < range_end; ++position) {
+                matched[documents.documents[position] - first] = 0;
+            }
+        }
+        TopDocuments top_documents(top_k);
+        for (int document_index = first; document_index < last; ++document_index) {
+            if (matched[document_index - first] && IsDocumentAccepted(doc_pred, document_index)) {
+                top_documents.Add(MakeDocument(document_index, scores[document_index - first]));
+            }
+        }
+        chunk_documents[chunk] = top_documents.Extract();
+    });
+    return MergeTopDocuments(chunk_documents, top_k);
 }
\ No newline at end of file
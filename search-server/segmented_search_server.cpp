@@ -0,0 +1,185 @@
+#include "segmented_search_server.h"
+
+#include <map>
+#include <stdexcept>
+
+SegmentedSearchServer::~SegmentedSearchServer() {
+    {
+        std::unique_lock lock(mutex_);
+        is_stopping_ = true;
+    }
+    merge_condition_.notify_all();
+    merge_thread_.join();
+}
+
+void SegmentedSearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                                        const std::vector<int>& ratings) {
+    // стоп-слова parser_ не меняются, поэтому разбор не требует блокировки
+    const auto prepared_document = parser_.PrepareDocument(document_id, document, status, ratings);
+    std::unique_lock lock(mutex_);
+    if (document_ids_.count(document_id)) {
+        throw std::invalid_argument("repeat document id");
+    }
+    mutable_segment_->AddDocument(prepared_document);
+    document_ids_.insert(document_id);
+    if (static_cast<size_t>(mutable_segment_->GetDocumentCount()) >= seal_threshold_) {
+        SealMutableSegment();
+    }
+}
+
+void SegmentedSearchServer::RemoveDocument(int document_id) {
+    std::unique_lock lock(mutex_);
+    if (document_ids_.erase(document_id) == 0) {
+        return;
+    }
+    if (mutable_segment_->HasDocument(document_id)) {
+        mutable_segment_->RemoveDocument(document_id);
+        return;
+    }
+    // сегмент, который сейчас сливается, читает фоновый поток, поэтому удаление из него откладывается
+    for (auto segment_it = sealed_segments_.rbegin(); segment_it != sealed_segments_.rend(); ++segment_it) {
+        if (!segment_it->search_server->HasDocument(document_id)
+            || (segment_it->is_merging && pending_removals_.count(document_id))) {
+            continue;
+        }
+        if (segment_it->is_merging) {
+            pending_removals_.insert(document_id);
+        } else {
+            segment_it->search_server->RemoveDocument(document_id);
+            merge_condition_.notify_all();
+        }
+        return;
+    }
+}
+
+std::vector<Document> SegmentedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentStatus status,
+                                                              size_t top_k) const {
+    return FindTopDocuments(raw_query, StatusFilter{status}, top_k);
+}
+
+std::tuple<std::vector<std::string>, DocumentStatus> SegmentedSearchServer::MatchDocument(
+        std::string_view raw_query, int document_id) const {
+    std::shared_lock lock(mutex_);
+    return FindDocumentSegment(document_id).MatchDocument(raw_query, document_id);
+}
+
+int SegmentedSearchServer::GetDocumentCount() const {
+    std::shared_lock lock(mutex_);
+    return document_ids_.size();
+}
+
+size_t SegmentedSearchServer::GetSegmentCount() const {
+    std::shared_lock lock(mutex_);
+    return sealed_segments_.size() + 1;
+}
+
+bool SegmentedSearchServer::IsMergeRunning() const {
+    std::shared_lock lock(mutex_);
+    return is_merge_running_;
+}
+
+void SegmentedSearchServer::WaitForMerges() const {
+    std::shared_lock lock(mutex_);
+    merge_condition_.wait(lock, [this] {
+        return is_stopping_ || (!is_merge_running_ && SelectMergeSegments().empty());
+    });
+}
+
+void SegmentedSearchServer::SealMutableSegment() {
+    const int document_count = mutable_segment_->GetDocumentCount();
+    sealed_segments_.push_back({std::shared_ptr<SearchServer>(std::move(mutable_segment_)), 0, document_count});
+    mutable_segment_ = std::make_unique<SearchServer>(stop_words_);
+    merge_condition_.notify_all();
+}
+
+std::vector<size_t> SegmentedSearchServer::SelectMergeSegments() const {
+    std::map<int, std::vector<size_t>> level_to_positions;
+    for (size_t i = 0; i < sealed_segments_.size(); ++i) {
+        const Segment& segment = sealed_segments_[i];
+        if (segment.search_server->GetDocumentCount() * 2 <= segment.initial_document_count) {
+            return {i};
+        }
+        std::vector<size_t>& positions = level_to_positions[segment.level];
+        positions.push_back(i);
+        if (positions.size() == merge_factor_) {
+            return positions;
+        }
+    }
+    return {};
+}
+
+void SegmentedSearchServer::RunMerges() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        std::vector<size_t> positions;
+        merge_condition_.wait(lock, [this, &positions] {
+            if (is_stopping_) {
+                return true;
+            }
+            positions = SelectMergeSegments();
+            return !positions.empty();
+        });
+        if (is_stopping_) {
+            return;
+        }
+        std::vector<std::shared_ptr<const SearchServer>> sources;
+        int level = 0;
+        for (const size_t position : positions) {
+            Segment& segment = sealed_segments_[position];
+            segment.is_merging = true;
+            sources.push_back(segment.search_server);
+            level = std::max(level, segment.level);
+        }
+        // одиночный сегмент только очищается от удалённых документов и остаётся на своём уровне
+        if (sources.size() > 1) {
+            ++level;
+        }
+        is_merge_running_ = true;
+
+        // сливаемые сегменты никто не меняет, а новые сегменты дописываются в конец,
+        // поэтому строить результат можно без блокировки
+        lock.unlock();
+        auto merged_segment = std::make_shared<SearchServer>(stop_words_);
+        for (const auto& source : sources) {
+            merged_segment->AddDocumentsFrom(*source);
+        }
+        lock.lock();
+
+        const int document_count = merged_segment->GetDocumentCount();
+        for (const int document_id : pending_removals_) {
+            merged_segment->RemoveDocument(document_id);
+        }
+        pending_removals_.clear();
+        // результат занимает место первого из исходных сегментов
+        Segment merged{merged_segment, level, document_count};
+        for (size_t i = positions.size(); i-- > 0;) {
+            if (i == 0 && merged_segment->GetDocumentCount() > 0) {
+                sealed_segments_[positions[i]] = std::move(merged);
+            } else {
+                sealed_segments_.erase(sealed_segments_.begin() + positions[i]);
+            }
+        }
+        is_merge_running_ = false;
+        merge_condition_.notify_all();
+        // освобождение памяти исходных сегментов долгое, его не нужно делать под блокировкой
+        lock.unlock();
+        sources.clear();
+        lock.lock();
+    }
+}
+
+SearchServer& SegmentedSearchServer::FindDocumentSegment(int document_id) const {
+    if (document_ids_.count(document_id) == 0) {
+        throw std::out_of_range("document id not found");
+    }
+    if (mutable_segment_->HasDocument(document_id)) {
+        return *mutable_segment_;
+    }
+    for (auto segment_it = sealed_segments_.rbegin(); segment_it != sealed_segments_.rend(); ++segment_it) {
+        if (segment_it->search_server->HasDocument(document_id)
+            && !(segment_it->is_merging && pending_removals_.count(document_id))) {
+            return *segment_it->search_server;
+        }
+    }
+    throw std::out_of_range("document id not found");
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "document.h"
+#include "search_server.h"
+#include "string_processing.h"
+#include "top_documents.h"
+
+// индекс из сегментов, как в LSM-дереве: новые документы попадают в небольшой изменяемый сегмент,
+// который по достижении seal_threshold документов запечатывается и больше не пополняется, только теряет
+// удаляемые документы. Фоновый поток сливает merge_factor запечатанных сегментов одного уровня в один
+// (уровнем выше, SearchServer::AddDocumentsFrom), где не остаётся следов удалённых документов;
+// сегмент, из которого удалена половина документов, перестраивается отдельно.
+// Поиск обходит все сегменты с IDF по всему корпусу (SearchServer::CorpusStatistics) и отбирает
+// общий топ, поэтому релевантности те же, что у одного SearchServer со всеми документами.
+// Поиск берёт разделяемую блокировку, добавление и удаление - исключительную, но короткую: вставка идёт
+// в маленький сегмент, а слияние строит новый сегмент без блокировки и только подменяет им исходные
+class SegmentedSearchServer {
+public:
+    static constexpr size_t DEFAULT_SEAL_THRESHOLD = 16384;
+    static constexpr size_t DEFAULT_MERGE_FACTOR = 4;
+
+    template <typename StringContainer>
+    explicit SegmentedSearchServer(const StringContainer& stop_words,
+                                   size_t seal_threshold = DEFAULT_SEAL_THRESHOLD,
+                                   size_t merge_factor = DEFAULT_MERGE_FACTOR);
+    explicit SegmentedSearchServer(const std::string& stop_words_text,
+                                   size_t seal_threshold = DEFAULT_SEAL_THRESHOLD,
+                                   size_t merge_factor = DEFAULT_MERGE_FACTOR)
+            : SegmentedSearchServer(SplitIntoWords(stop_words_text), seal_threshold, merge_factor) {
+    }
+
+    // останавливает фоновое слияние; начатое слияние дорабатывается
+    ~SegmentedSearchServer();
+
+    SegmentedSearchServer(const SegmentedSearchServer&) = delete;
+    SegmentedSearchServer& operator=(const SegmentedSearchServer&) = delete;
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                     const std::vector<int>& ratings);
+
+    void RemoveDocument(int document_id);
+
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    template <typename predicate>
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, predicate predict,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::tuple<std::vector<std::string>, DocumentStatus> MatchDocument(std::string_view raw_query,
+                                                                       int document_id) const;
+
+    int GetDocumentCount() const;
+
+    // число сегментов вместе с изменяемым
+    size_t GetSegmentCount() const;
+
+    // идёт ли сейчас фоновое слияние
+    bool IsMergeRunning() const;
+
+    // ждёт, пока фоновый поток не выполнит все слияния, которые требуются при текущем наборе сегментов
+    void WaitForMerges() const;
+
+private:
+    struct Segment {
+        std::shared_ptr<SearchServer> search_server;
+        // сколько раз документы сегмента уже сливались
+        int level = 0;
+        // документов при запечатывании или слиянии; с текущим числом даёт долю удалённых
+        int initial_document_count = 0;
+        bool is_merging = false;
+    };
+
+    std::set<std::string, std::less<>> stop_words_;
+    size_t seal_threshold_;
+    size_t merge_factor_;
+    // пустой сервер с теми же стоп-словами: разбирает тексты новых документов без блокировки
+    const SearchServer parser_;
+
+    mutable std::shared_mutex mutex_;
+    mutable std::condition_variable_any merge_condition_;
+    std::unique_ptr<SearchServer> mutable_segment_;
+    std::vector<Segment> sealed_segments_;
+    // id всех документов индекса
+    std::set<int> document_ids_;
+    // документы, удалённые из сегментов, которые сейчас сливаются: до подмены сегментов результатом слияния
+    // они скрываются из выдачи и не учитываются в IDF, а затем удаляются из нового сегмента
+    std::set<int> pending_removals_;
+    bool is_merge_running_ = false;
+    bool is_stopping_ = false;
+    std::thread merge_thread_;
+
+    void SealMutableSegment();
+
+    // номера запечатанных сегментов для следующего слияния; пусто, если сливать нечего
+    std::vector<size_t> SelectMergeSegments() const;
+
+    void RunMerges();
+
+    // сегмент, где лежит документ индекса; копии удалённых документов в сливаемых сегментах пропускаются
+    SearchServer& FindDocumentSegment(int document_id) const;
+
+    // все сегменты в порядке от старых к новым
+    template <typename Function>
+    void ForEachSegment(Function function) const;
+};
+
+template <typename StringContainer>
+SegmentedSearchServer::SegmentedSearchServer(const StringContainer& stop_words, size_t seal_threshold,
+                                             size_t merge_factor)
+        : stop_words_(MakeUniqueNonEmptyStrings(stop_words))
+        , seal_threshold_(std::max<size_t>(seal_threshold, 1))
+        , merge_factor_(std::max<size_t>(merge_factor, 2))
+        , parser_(stop_words_)
+        , mutable_segment_(std::make_unique<SearchServer>(stop_words_)) {
+    merge_thread_ = std::thread([this] {
+        RunMerges();
+    });
+}
+
+template <typename predicate>
+std::vector<Document> SegmentedSearchServer::FindTopDocuments(std::string_view raw_query, predicate predict,
+                                                              size_t top_k) const {
+    std::shared_lock lock(mutex_);
+    SearchServer::CorpusStatistics statistics;
+    ForEachSegment([&](const SearchServer& segment) {
+        segment.CollectCorpusStatistics(raw_query, statistics);
+    });
+    // в сливаемых сегментах ещё лежат удалённые из них документы: они не входят ни в выдачу, ни в IDF
+    for (const Segment& segment : sealed_segments_) {
+        if (segment.is_merging) {
+            for (const int document_id : pending_removals_) {
+                segment.search_server->ExcludeFromCorpusStatistics(document_id, statistics);
+            }
+        }
+    }
+    const auto is_not_removed = [this, &predict](int document_id, DocumentStatus status, int rating) {
+        return pending_removals_.count(document_id) == 0 && predict(document_id, status, rating);
+    };
+    // документ лежит ровно в одном сегменте, поэтому общий топ отбирается из топов сегментов
+    TopDocuments top_documents(top_k);
+    const auto add_documents = [&top_documents](const std::vector<Document>& documents) {
+        for (const Document& document : documents) {
+            top_documents.Add(document);
+        }
+    };
+    for (const Segment& segment : sealed_segments_) {
+        if (segment.is_merging && !pending_removals_.empty()) {
+            add_documents(segment.search_server->FindTopDocuments(raw_query, statistics, is_not_removed, top_k));
+        } else {
+            add_documents(segment.search_server->FindTopDocuments(raw_query, statistics, predict, top_k));
+        }
+    }
+    add_documents(mutable_segment_->FindTopDocuments(raw_query, statistics, predict, top_k));
+    return top_documents.Extract();
+}
+
+template <typename Function>
+void SegmentedSearchServer::ForEachSegment(Function function) const {
+    for (const Segment& segment : sealed_segments_) {
+        function(static_cast<const SearchServer&>(*segment.search_server));
+    }
+    function(static_cast<const SearchServer&>(*mutable_segment_));
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "sharded_search_server.h"
+
+#include <execution>
+#include <stdexcept>
+
+ShardedSearchServer::Shard::Shard(const std::set<std::string, std::less<>>& stop_words)
+        : search_server_(stop_words) {
+    thread_ = std::thread([this] {
+        Run();
+    });
+}
+
+ShardedSearchServer::Shard::~Shard() {
+    {
+        std::lock_guard guard(mutex_);
+        is_stopping_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+}
+
+void ShardedSearchServer::Shard::Run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        condition_.wait(lock, [this] {
+            return is_stopping_ || !tasks_.empty();
+        });
+        if (tasks_.empty()) {
+            return;
+        }
+        std::packaged_task<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+const SearchServer& ShardedSearchServer::Shard::GetSearchServer() const {
+    return search_server_;
+}
+
+void ShardedSearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                                      const std::vector<int>& ratings) {
+    const auto prepared_document = parser_.PrepareDocument(document_id, document, status, ratings);
+    std::unique_lock lock(mutex_);
+    if (document_ids_.count(document_id)) {
+        throw std::invalid_argument("repeat document id");
+    }
+    RunOnShard(document_id, [&prepared_document](SearchServer& search_server) {
+        search_server.AddDocument(prepared_document);
+    });
+    document_ids_.insert(document_id);
+}
+
+void ShardedSearchServer::AddDocuments(const std::vector<SearchServer::DocumentToAdd>& documents) {
+    const auto prepared_documents = parser_.PrepareDocuments(std::execution::par, documents);
+    std::unique_lock lock(mutex_);
+    std::set<int> batch_ids;
+    for (const SearchServer::PreparedDocument& document : prepared_documents) {
+        if (document_ids_.count(document.id) || !batch_ids.insert(document.id).second) {
+            throw std::invalid_argument("repeat document id");
+        }
+    }
+    std::vector<std::vector<const SearchServer::PreparedDocument*>> shard_documents(shards_.size());
+    for (const SearchServer::PreparedDocument& document : prepared_documents) {
+        shard_documents[GetShardIndex(document.id)].push_back(&document);
+    }
+    ForEachShard([&shard_documents](size_t shard_index, SearchServer& search_server) {
+        for (const SearchServer::PreparedDocument* document : shard_documents[shard_index]) {
+            search_server.AddDocument(*document);
+        }
+    });
+    document_ids_.merge(batch_ids);
+}
+
+void ShardedSearchServer::RemoveDocument(int document_id) {
+    std::unique_lock lock(mutex_);
+    if (document_ids_.erase(document_id) == 0) {
+        return;
+    }
+    RunOnShard(document_id, [document_id](SearchServer& search_server) {
+        search_server.RemoveDocument(document_id);
+    });
+}
+
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentStatus status,
+                                                            size_t top_k) const {
+    return FindTopDocuments(raw_query, StatusFilter{status}, top_k);
+}
+
+std::tuple<std::vector<std::string>, DocumentStatus> ShardedSearchServer::MatchDocument(
+        std::string_view raw_query, int document_id) const {
+    std::shared_lock lock(mutex_);
+    return shards_[GetShardIndex(document_id)]->GetSearchServer().MatchDocument(raw_query, document_id);
+}
+
+int ShardedSearchServer::GetDocumentCount() const {
+    std::shared_lock lock(mutex_);
+    return document_ids_.size();
+}
+
+size_t ShardedSearchServer::GetShardCount() const {
+    return shards_.size();
+}
+
+size_t ShardedSearchServer::GetShardIndex(int document_id) const {
+    // перемешивание Фибоначчи: id с общим шагом не скапливаются в одном шарде
+    const uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(document_id)) * 0x9E3779B97F4A7C15ull;
+    return (hash >> 32) % shards_.size();
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <execution>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "document.h"
+#include "search_server.h"
+#include "string_processing.h"
+#include "top_documents.h"
+
+// корпус, разделённый по документам между shard_count шардами (SearchServer) по хэшу id.
+// У каждого шарда свой поток, через который идут изменения его индекса. Запрос рассылается всем шардам
+// дважды: сначала они собирают числа документов со словами запроса (SearchServer::CorpusStatistics),
+// затем ищут с IDF по всему корпусу, и топы шардов сливаются (MergeTopDocuments). Релевантности совпадают
+// до бита с одним SearchServer со всеми документами.
+// Поиск берёт разделяемую блокировку, изменения - исключительную, чтобы запрос видел одно состояние корпуса
+// в обоих проходах. Под разделяемой блокировкой индексы шардов не меняются, поэтому поиск идёт не через
+// потоки шардов, а параллельными алгоритмами: одновременные запросы выполняются на одном шарде
+// одновременно, а не по очереди
+class ShardedSearchServer {
+public:
+    template <typename StringContainer>
+    ShardedSearchServer(const StringContainer& stop_words, size_t shard_count);
+    ShardedSearchServer(const std::string& stop_words_text, size_t shard_count)
+            : ShardedSearchServer(SplitIntoWords(stop_words_text), shard_count) {
+    }
+
+    ShardedSearchServer(const ShardedSearchServer&) = delete;
+    ShardedSearchServer& operator=(const ShardedSearchServer&) = delete;
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status,
+                     const std::vector<int>& ratings);
+
+    // тексты разбираются параллельно, затем шарды вставляют свои документы одновременно.
+    // Некорректный документ или занятый id - исключение до изменения индекса
+    void AddDocuments(const std::vector<SearchServer::DocumentToAdd>& documents);
+
+    void RemoveDocument(int document_id);
+
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // предикат вызывается одновременно из потоков разных шардов
+    template <typename predicate>
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, predicate predict,
+                                           size_t top_k = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::tuple<std::vector<std::string>, DocumentStatus> MatchDocument(std::string_view raw_query,
+                                                                       int document_id) const;
+
+    int GetDocumentCount() const;
+
+    size_t GetShardCount() const;
+
+private:
+    // SearchServer со своим потоком: задачи выполняются по одной в порядке постановки
+    class Shard {
+    public:
+        explicit Shard(const std::set<std::string, std::less<>>& stop_words);
+        // дорабатывает поставленные задачи и останавливает поток
+        ~Shard();
+
+        // ставит function(search_server) в очередь; future сообщает о завершении или передаёт исключение
+        template <typename Function>
+        std::future<void> Post(Function function);
+
+        // индекс для чтения в обход потока; только пока нет задач, то есть под разделяемой блокировкой
+        // ShardedSearchServer
+        const SearchServer& GetSearchServer() const;
+
+    private:
+        SearchServer search_server_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<std::packaged_task<void()>> tasks_;
+        bool is_stopping_ = false;
+        std::thread thread_;
+
+        void Run();
+    };
+
+    // пустой сервер с теми же стоп-словами: разбирает тексты на вызывающем потоке
+    const SearchServer parser_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    mutable std::shared_mutex mutex_;
+    std::set<int> document_ids_;
+
+    size_t GetShardIndex(int document_id) const;
+
+    // выполняет function(shard_index, search_server) на всех шардах сразу и ждёт их; исключение
+    // первого по номеру шарда, где оно возникло, выбрасывается после завершения всех
+    template <typename Function>
+    void ForEachShard(Function function) const;
+
+    // то же для чтения под разделяемой блокировкой: function(shard_index, const search_server) выполняется
+    // параллельным алгоритмом на вызывающем потоке и потоках планировщика, а не в очередях шардов
+    template <typename Function>
+    void ReadEachShard(Function function) const;
+
+    // выполняет function(search_server) на шарде документа и ждёт результата
+    template <typename Function>
+    void RunOnShard(int document_id, Function function) const;
+};
+
+template <typename StringContainer>
+ShardedSearchServer::ShardedSearchServer(const StringContainer& stop_words, size_t shard_count)
+        : parser_(stop_words) {
+    const auto unique_stop_words = MakeUniqueNonEmptyStrings(stop_words);
+    for (size_t i = 0; i < std::max<size_t>(shard_count, 1); ++i) {
+        shards_.push_back(std::make_unique<Shard>(unique_stop_words));
+    }
+}
+
+template <typename predicate>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, predicate predict,
+                                                            size_t top_k) const {
+    std::shared_lock lock(mutex_);
+    std::vector<SearchServer::CorpusStatistics> shard_statistics(shards_.size());
+    ReadEachShard([&](size_t shard_index, const SearchServer& search_server) {
+        search_server.CollectCorpusStatistics(raw_query, shard_statistics[shard_index]);
+    });
+    SearchServer::CorpusStatistics statistics;
+    for (const SearchServer::CorpusStatistics& shard : shard_statistics) {
+        statistics.document_count += shard.document_count;
+        for (const auto& [word, document_freq] : shard.document_freqs) {
+            statistics.document_freqs[word] += document_freq;
+        }
+    }
+    std::vector<std::vector<Document>> shard_documents(shards_.size());
+    ReadEachShard([&](size_t shard_index, const SearchServer& search_server) {
+        shard_documents[shard_index] = search_server.FindTopDocuments(raw_query, statistics, predict, top_k);
+    });
+    return MergeTopDocuments(shard_documents, top_k);
+}
+
+template <typename Function>
+std::future<void> ShardedSearchServer::Shard::Post(Function function) {
+    std::packaged_task<void()> task([this, function = std::move(function)]() mutable {
+        function(search_server_);
+    });
+    std::future<void> result = task.get_future();
+    {
+        std::lock_guard guard(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+    return result;
+}
+
+template <typename Function>
+void ShardedSearchServer::ForEachShard(Function function) const {
+    std::vector<std::future<void>> results;
+    results.reserve(shards_.size());
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        results.push_back(shards_[i]->Post([i, &function](SearchServer& search_server) {
+            function(i, search_server);
+        }));
+    }
+    for (std::future<void>& result : results) {
+        result.wait();
+    }
+    for (std::future<void>& result : results) {
+        result.get();
+    }
+}
+
+template <typename Function>
+void ShardedSearchServer::ReadEachShard(Function function) const {
+    std::vector<size_t> shard_indexes(shards_.size());
+    std::iota(shard_indexes.begin(), shard_indexes.end(), size_t{0});
+    // исключение внутри параллельного алгоритма завершило бы программу, поэтому оно сохраняется
+    std::vector<std::exception_ptr> errors(shards_.size());
+    std::for_each(std::execution::par, shard_indexes.begin(), shard_indexes.end(), [&](size_t shard_index) {
+        try {
+            function(shard_index, shards_[shard_index]->GetSearchServer());
+        } catch (...) {
+            errors[shard_index] = std::current_exception();
+        }
+    });
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+template <typename Function>
+void ShardedSearchServer::RunOnShard(int document_id, Function function) const {
+    shards_[GetShardIndex(document_id)]->Post([&function](SearchServer& search_server) {
+        function(search_server);
+    }).get();
+}
\ No newline at end of file
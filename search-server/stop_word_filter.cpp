@@ -0,0 +1,44 @@
+#include "stop_word_filter.h"
+
+#include <stdexcept>
+
+StopWordFilter::StopWordFilter(const std::set<std::string, std::less<>>& stop_words) {
+    size_t slot_count = 1;
+    while (slot_count < stop_words.size() * 2) {
+        slot_count *= 2;
+    }
+    slots_.resize(slot_count);
+    for (const std::string& stop_word : stop_words) {
+        if (stop_word.empty()) {
+            continue;
+        }
+        if (characters_.size() + stop_word.size() > UINT32_MAX) {
+            throw std::length_error("stop words are too long");
+        }
+        const uint64_t signature = ComputeSignature(stop_word);
+        for (const uint64_t bit : {signature >> 52, (signature >> 40) & (PREFILTER_BITS - 1)}) {
+            prefilter_[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+        size_t slot = std::hash<std::string_view>{}(stop_word) & (slots_.size() - 1);
+        while (slots_[slot].length != 0) {
+            slot = (slot + 1) & (slots_.size() - 1);
+        }
+        slots_[slot] = {static_cast<uint32_t>(characters_.size()), static_cast<uint32_t>(stop_word.size())};
+        characters_ += stop_word;
+    }
+}
+
+bool StopWordFilter::ContainsExactly(std::string_view word) const {
+    if (slots_.empty()) {
+        return false;
+    }
+    size_t slot = std::hash<std::string_view>{}(word) & (slots_.size() - 1);
+    while (slots_[slot].length != 0) {
+        if (slots_[slot].length == word.size()
+            && std::string_view(characters_).substr(slots_[slot].offset, slots_[slot].length) == word) {
+            return true;
+        }
+        slot = (slot + 1) & (slots_.size() - 1);
+    }
+    return false;
+}
\ No newline at end of file
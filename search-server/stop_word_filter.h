@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// неизменяемое множество стоп-слов, которое строится один раз в конструкторе SearchServer.
+// Проверка слова идёт в два шага: префильтр Блума (4096 бит) по длине и крайним символам отсекает
+// почти все обычные слова, не читая их целиком; остальные ищутся в плоской хэш-таблице с открытой
+// адресацией, заполненной не больше чем наполовину, где слова лежат подряд в одной строке.
+// Без стоп-слов префильтр пуст, и проверка - одно чтение бита
+class StopWordFilter {
+public:
+    StopWordFilter() = default;
+    explicit StopWordFilter(const std::set<std::string, std::less<>>& stop_words);
+
+    bool Contains(std::string_view word) const {
+        if (word.empty()) {
+            return false;
+        }
+        const uint64_t signature = ComputeSignature(word);
+        const uint64_t first_bit = signature >> 52;
+        const uint64_t second_bit = (signature >> 40) & (PREFILTER_BITS - 1);
+        if (((prefilter_[first_bit / 64] >> (first_bit % 64)) & 1) == 0
+            || ((prefilter_[second_bit / 64] >> (second_bit % 64)) & 1) == 0) {
+            return false;
+        }
+        return ContainsExactly(word);
+    }
+
+private:
+    static constexpr uint64_t PREFILTER_BITS = 4096;
+
+    // положение слова в characters_; пустой слот - length == 0
+    struct Slot {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    std::array<uint64_t, PREFILTER_BITS / 64> prefilter_{};
+    std::string characters_;
+    std::vector<Slot> slots_;
+
+    // смешивает длину и крайние символы; биты префильтра берутся из старших разрядов
+    static uint64_t ComputeSignature(std::string_view word) {
+        const uint64_t key = word.size()
+                             | static_cast<uint64_t>(static_cast<unsigned char>(word.front())) << 32
+                             | static_cast<uint64_t>(static_cast<unsigned char>(word.back())) << 40;
+        return key * 0x9E3779B97F4A7C15ull;
+    }
+
+    bool ContainsExactly(std::string_view word) const;
+};
\ No newline at end of file
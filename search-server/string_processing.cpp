@@ -1,21 +1,111 @@
 #include "string_processing.h"
 
-// функция разбиения на слова и записи в вектор слов words
-std::vector<std::string> SplitIntoWords(const std::string& text) {
-    std::vector<std::string> words;
-    std::string word;
-    for (const char c : text) {
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+bool IsControlCharacter(char c) {
+    return c >= '\0' && c < ' ';
+}
+
+// один проход по тексту: границы слов и, если check_characters, поиск символов с кодами от 0 до 31.
+// Блоки по 16 байт сравниваются с пробелом и управляющими символами целиком (SSE2), а границы слов
+// находятся по маске пробелов: бит меняется там, где слово начинается или кончается
+template <bool check_characters>
+bool SplitWords(std::string_view text, std::vector<std::string_view>& words) {
+    words.clear();
+    const char* const data = text.data();
+    const size_t size = text.size();
+    // начало текущего слова; size, пока идут пробелы
+    size_t word_begin = size;
+    size_t position = 0;
+#if defined(__SSE2__)
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i minus_one = _mm_set1_epi8(-1);
+    for (; position + 16 <= size; position += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+        if constexpr (check_characters) {
+            // сравнение знаковое: байты от 0x80 отрицательны, поэтому нужен и порог снизу
+            const __m128i is_control = _mm_and_si128(_mm_cmplt_epi8(block, spaces), _mm_cmpgt_epi8(block, minus_one));
+            if (_mm_movemask_epi8(is_control) != 0) {
+                return false;
+            }
+        }
+        const unsigned space_mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, spaces)));
+        // бит i - пробел ли байт перед i-м; перед блоком - пробел, если слово не начато
+        const unsigned previous_space_mask = (space_mask << 1) | (word_begin == size ? 1u : 0u);
+        unsigned boundaries = (space_mask ^ previous_space_mask) & 0xFFFFu;
+        while (boundaries != 0) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(boundaries));
+            if ((space_mask >> bit) & 1u) {
+                words.push_back(text.substr(word_begin, position + bit - word_begin));
+                word_begin = size;
+            } else {
+                word_begin = position + bit;
+            }
+            boundaries &= boundaries - 1;
+        }
+    }
+#endif
+    for (; position < size; ++position) {
+        const char c = data[position];
+        if constexpr (check_characters) {
+            if (IsControlCharacter(c)) {
+                return false;
+            }
+        }
         if (c == ' ') {
-            if (!word.empty()) {
-                words.push_back(word);
-                word.clear();
+            if (word_begin != size) {
+                words.push_back(text.substr(word_begin, position - word_begin));
+                word_begin = size;
             }
-        } else {
-            word += c;
+        } else if (word_begin == size) {
+            word_begin = position;
         }
     }
-    if (!word.empty()) {
-        words.push_back(word);
+    if (word_begin != size) {
+        words.push_back(text.substr(word_begin));
     }
+    return true;
+}
+
+} // namespace
+
+// функция разбиения на слова и записи в вектор слов words
+std::vector<std::string_view> SplitIntoWords(std::string_view text) {
+    std::vector<std::string_view> words;
+    SplitIntoWords(text, words);
     return words;
+}
+
+void SplitIntoWords(std::string_view text, std::vector<std::string_view>& words) {
+    SplitWords<false>(text, words);
+}
+
+bool SplitIntoValidWords(std::string_view text, std::vector<std::string_view>& words) {
+    return SplitWords<true>(text, words);
+}
+
+bool HasNoControlCharacters(std::string_view text) {
+    const char* const data = text.data();
+    size_t position = 0;
+#if defined(__SSE2__)
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i minus_one = _mm_set1_epi8(-1);
+    for (; position + 16 <= text.size(); position += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+        const __m128i is_control = _mm_and_si128(_mm_cmplt_epi8(block, spaces), _mm_cmpgt_epi8(block, minus_one));
+        if (_mm_movemask_epi8(is_control) != 0) {
+            return false;
+        }
+    }
+#endif
+    for (; position < text.size(); ++position) {
+        if (IsControlCharacter(data[position])) {
+            return false;
+        }
+    }
+    return true;
 }
\ No newline at end of file
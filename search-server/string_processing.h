@@ -2,18 +2,25 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <string_view>
 
-std::vector<std::string> SplitIntoWords(const std::string& text);
+// слова возвращаются как срезы исходного текста, поэтому text должен жить, пока используются слова
+std::vector<std::string_view> SplitIntoWords(std::string_view text);
+// то же в готовый вектор, чтобы переиспользовать его ёмкость
+void SplitIntoWords(std::string_view text, std::vector<std::string_view>& words);
+// то же с проверкой символов в том же проходе: false, если в тексте есть символ с кодом от 0 до 31
+// (words тогда заполнен не до конца)
+bool SplitIntoValidWords(std::string_view text, std::vector<std::string_view>& words);
+// true, если в тексте нет символов с кодами от 0 до 31
+bool HasNoControlCharacters(std::string_view text);
 
 template <typename StringCollection>
-std::set<std::string> MakeUniqueNonEmptyStrings(const StringCollection& strings) {
-    std::set<std::string> non_empty_strings;
-    for (const std::string& str : strings) {
+std::set<std::string, std::less<>> MakeUniqueNonEmptyStrings(const StringCollection& strings) {
+    std::set<std::string, std::less<>> non_empty_strings;
+    for (const auto& str : strings) {
         if (!str.empty()) {
-            non_empty_strings.insert(str);
+            non_empty_strings.emplace(str);
         }
     }
     return non_empty_strings;
-}
-
-
+}
\ No newline at end of file
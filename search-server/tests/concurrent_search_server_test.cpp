@@ -0,0 +1,109 @@
+// проверка ConcurrentSearchServer: пакет с занятым или повторяющимся id отвергается целиком, а поиск,
+// идущий одновременно с добавлением пакетов, не мешает вставке - в конце индекс совпадает с SearchServer,
+// в который те же документы добавлены последовательно.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/concurrent_search_server_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o concurrent_search_server_test
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../concurrent_search_server.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 1000;
+constexpr size_t BATCH_SIZE = 500;
+
+std::vector<SearchServer::DocumentToAdd> MakeBatch(const std::vector<TestDocument>& documents, size_t first,
+                                                   size_t last) {
+    std::vector<SearchServer::DocumentToAdd> batch;
+    for (size_t i = first; i < last; ++i) {
+        batch.push_back({documents[i].id, documents[i].text, documents[i].status, documents[i].ratings});
+    }
+    return batch;
+}
+
+// true, если пакет отвергнут исключением invalid_argument и не изменил число документов
+bool IsBatchRejected(ConcurrentSearchServer& search_server, const std::vector<SearchServer::DocumentToAdd>& batch) {
+    const int document_count = search_server.GetDocumentCount();
+    try {
+        search_server.AddDocuments(batch);
+    } catch (const std::invalid_argument&) {
+        return search_server.GetDocumentCount() == document_count;
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(8);
+    const std::vector<TestDocument> documents = GenerateTestDocuments(generator, 20000, VOCABULARY_SIZE);
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 200, VOCABULARY_SIZE);
+    SearchServer reference("and in"s);
+    for (const TestDocument& document : documents) {
+        reference.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+
+    ConcurrentSearchServer search_server(SearchServer("and in"s));
+    std::atomic<bool> is_ingesting{true};
+    std::atomic<size_t> query_count{0};
+    std::thread reader([&] {
+        for (size_t i = 0; is_ingesting; ++i) {
+            search_server.FindTopDocuments(queries[i % queries.size()]);
+            ++query_count;
+        }
+    });
+    for (size_t first = 0; first < documents.size(); first += BATCH_SIZE) {
+        search_server.AddDocuments(MakeBatch(documents, first, std::min(first + BATCH_SIZE, documents.size())));
+    }
+    is_ingesting = false;
+    reader.join();
+
+    int failure_count = 0;
+    for (const std::string& query : queries) {
+        failure_count += !IsIdenticalResult(reference.FindTopDocuments(query), search_server.FindTopDocuments(query),
+                                            "'" + query + "'");
+    }
+
+    // новые документы, среди которых в разных местах пакета повторяющийся или уже занятый id
+    std::vector<TestDocument> extra_documents = GenerateTestDocuments(generator, 100, VOCABULARY_SIZE);
+    for (TestDocument& document : extra_documents) {
+        document.id += 1000000;
+    }
+    const std::vector<SearchServer::DocumentToAdd> extra_batch = MakeBatch(extra_documents, 0, extra_documents.size());
+    for (const size_t position : {size_t{0}, size_t{50}, extra_batch.size()}) {
+        for (const int repeated_id : {extra_batch[10].id, documents[123].id}) {
+            std::vector<SearchServer::DocumentToAdd> batch = extra_batch;
+            batch.insert(batch.begin() + position, {repeated_id, "fresh words", DocumentStatus::ACTUAL, {1}});
+            if (!IsBatchRejected(search_server, batch)) {
+                ++failure_count;
+                std::cerr << "batch with id " << repeated_id << " at " << position << " was not rejected" << std::endl;
+            }
+        }
+    }
+    std::vector<SearchServer::DocumentToAdd> bad_batch = extra_batch;
+    bad_batch[70].text = "bad\x02word";
+    if (!IsBatchRejected(search_server, bad_batch)) {
+        ++failure_count;
+        std::cerr << "batch with an invalid word was not rejected" << std::endl;
+    }
+    // проверенный пакет после отвергнутых вставляется целиком
+    search_server.AddDocuments(extra_batch);
+    if (search_server.GetDocumentCount() != static_cast<int>(documents.size() + extra_documents.size())) {
+        ++failure_count;
+        std::cerr << "valid batch after rejected ones was not added" << std::endl;
+    }
+
+    if (failure_count > 0) {
+        std::cerr << failure_count << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << query_count << " queries during ingestion" << std::endl;
+}
\ No newline at end of file
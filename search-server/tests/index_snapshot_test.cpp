@@ -0,0 +1,214 @@
+// проверка снимков индекса: сервер, загруженный из снимка, отвечает на запросы так же, как сохранённый,
+// а повреждённый снимок отвергается исключением runtime_error с причиной. Повреждения вносятся в файл
+// по его формату (index_snapshot.cpp) с пересчётом контрольной суммы секции, чтобы дойти до проверок содержимого.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/index_snapshot_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o index_snapshot_test
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../index_snapshot.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 2000;
+
+// разметка файла снимка: заголовок, таблица секций и номера секций
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t SECTION_ENTRY_SIZE = 24;
+enum Section { STOP_WORDS, DOCUMENTS, TERMS, POSTING_DOCUMENTS, POSTING_TERM_FREQS };
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void WriteFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+uint32_t ComputeCrc32(const char* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= static_cast<uint8_t>(data[i]);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// правит секцию файла снимка: patch получает начало секции; контрольная сумма пересчитывается,
+// если is_checksum_fixed
+void PatchSection(std::string& file, Section section, const std::function<void(char*)>& patch,
+                  bool is_checksum_fixed = true) {
+    char* entry = file.data() + HEADER_SIZE + section * SECTION_ENTRY_SIZE;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    std::memcpy(&offset, entry, sizeof(offset));
+    std::memcpy(&size, entry + 8, sizeof(size));
+    patch(file.data() + offset);
+    if (is_checksum_fixed) {
+        const uint32_t checksum = ComputeCrc32(file.data() + offset, size);
+        std::memcpy(entry + 16, &checksum, sizeof(checksum));
+    }
+}
+
+int CompareServers(const SearchServer& expected, const SearchServer& actual, const std::vector<std::string>& queries) {
+    int mismatch_count = 0;
+    if (expected.GetDocumentCount() != actual.GetDocumentCount()
+        || !std::equal(expected.begin(), expected.end(), actual.begin(), actual.end())) {
+        ++mismatch_count;
+        std::cerr << "document ids differ" << std::endl;
+    }
+    for (const std::string& query : queries) {
+        for (const DocumentStatus status : {DocumentStatus::ACTUAL, DocumentStatus::BANNED}) {
+            for (const size_t top_k : {size_t{5}, size_t{1000}}) {
+                mismatch_count += !IsIdenticalResult(expected.FindTopDocuments(query, status, top_k),
+                                                     actual.FindTopDocuments(query, status, top_k),
+                                                     "'" + query + "'");
+            }
+        }
+    }
+    for (const int document_id : expected) {
+        const std::string& query = queries[document_id % queries.size()];
+        if (expected.GetWordFrequencies(document_id) != actual.GetWordFrequencies(document_id)
+            || expected.MatchDocument(query, document_id) != actual.MatchDocument(query, document_id)) {
+            ++mismatch_count;
+            std::cerr << "document " << document_id << " differs" << std::endl;
+        }
+    }
+    return mismatch_count;
+}
+
+// true, если загрузка снимка выбросила runtime_error с reason в сообщении
+bool IsRejected(const std::string& path, const std::string& reason) {
+    try {
+        LoadSnapshot(path);
+    } catch (const std::runtime_error& e) {
+        if (std::string(e.what()).find(reason) != std::string::npos) {
+            return true;
+        }
+        std::cerr << "expected '" << reason << "', got '" << e.what() << "'" << std::endl;
+        return false;
+    }
+    std::cerr << "snapshot accepted, expected '" << reason << "'" << std::endl;
+    return false;
+}
+
+} // namespace
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "index_snapshot_test.snapshot").string();
+    int failure_count = 0;
+
+    // сохранение и загрузка: после удалений номера документов уплотняются, сжатые списки пишутся обычными
+    std::mt19937 generator(3);
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 300, VOCABULARY_SIZE);
+    for (const auto layout : {SearchServer::PostingListLayout::PLAIN, SearchServer::PostingListLayout::COMPRESSED}) {
+        SearchServer search_server("and in"s);
+        search_server.SetPostingListLayout(layout);
+        const std::vector<TestDocument> documents = GenerateTestDocuments(generator, 10000, VOCABULARY_SIZE);
+        for (const TestDocument& document : documents) {
+            search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+        }
+        for (size_t i = 0; i < documents.size(); i += 5) {
+            search_server.RemoveDocument(documents[i].id);
+        }
+        SaveSnapshot(search_server, path);
+        const SearchServer loaded_server = LoadSnapshot(path);
+        failure_count += CompareServers(search_server, loaded_server, queries);
+        // загруженный сервер снова сохраняется в тот же снимок
+        SaveSnapshot(loaded_server, path + ".2");
+        if (ReadFile(path) != ReadFile(path + ".2")) {
+            ++failure_count;
+            std::cerr << "snapshot of a loaded server differs" << std::endl;
+        }
+        std::filesystem::remove(path + ".2");
+    }
+
+    // маленький индекс с известным содержимым секций: документы 0, 1, 2; слова aaa (0, 1), bbb (0, 2), ccc (1, 2)
+    SearchServer search_server("and"s);
+    search_server.AddDocument(10, "aaa bbb"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(20, "aaa and ccc"s, DocumentStatus::BANNED, {2});
+    search_server.AddDocument(30, "bbb ccc"s, DocumentStatus::ACTUAL, {3});
+    SaveSnapshot(search_server, path);
+    const std::string snapshot = ReadFile(path);
+    failure_count += CompareServers(search_server, LoadSnapshot(path), {"aaa"s, "bbb -ccc"s, "aaa ccc"s});
+
+    struct Corruption {
+        std::string reason;
+        std::function<void(std::string&)> apply;
+    };
+    const std::vector<Corruption> corruptions = {
+        {"checksum mismatch", [](std::string& file) {
+             PatchSection(file, DOCUMENTS, [](char* data) { ++data[8]; }, false);
+         }},
+        {"invalid document status", [](std::string& file) {
+             // статус первого документа: после числа документов и его id и рейтинга
+             PatchSection(file, DOCUMENTS, [](char* data) {
+                 const int32_t status = 7;
+                 std::memcpy(data + 16, &status, sizeof(status));
+             });
+         }},
+        {"terms are repeated or out of order", [](std::string& file) {
+             // второе слово "bbb" после числа слов, записи "aaa" (длина, буквы, размер списка) и своей длины
+             PatchSection(file, TERMS, [](char* data) { std::memcpy(data + 27, "aaa", 3); });
+         }},
+        {"terms are repeated or out of order", [](std::string& file) {
+             PatchSection(file, TERMS, [](char* data) { std::memcpy(data + 27, "zzz", 3); });
+         }},
+        {"posting list is not sorted", [](std::string& file) {
+             // список слова aaa: документы 0, 1 меняются местами
+             PatchSection(file, POSTING_DOCUMENTS, [](char* data) {
+                 std::swap_ranges(data, data + 4, data + 4);
+             });
+         }},
+        {"unknown document", [](std::string& file) {
+             PatchSection(file, POSTING_DOCUMENTS, [](char* data) {
+                 const int32_t document_index = 3;
+                 std::memcpy(data + 4, &document_index, sizeof(document_index));
+             });
+         }},
+        {"repeated document id", [](std::string& file) {
+             PatchSection(file, DOCUMENTS, [](char* data) {
+                 const int32_t document_id = 10;
+                 std::memcpy(data + 8 + 16, &document_id, sizeof(document_id));
+             });
+         }},
+        {"is truncated", [](std::string& file) {
+             file.resize(file.size() - 4);
+         }},
+        {"is not a search server snapshot", [](std::string& file) {
+             file[0] = 'X';
+         }},
+        {"unsupported snapshot version", [](std::string& file) {
+             ++file[8];
+         }},
+    };
+    for (const Corruption& corruption : corruptions) {
+        std::string file = snapshot;
+        corruption.apply(file);
+        WriteFile(path, file);
+        failure_count += !IsRejected(path, corruption.reason);
+    }
+    std::filesystem::remove(path);
+
+    if (failure_count > 0) {
+        std::cerr << failure_count << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: round trip and " << corruptions.size() << " corrupted snapshots" << std::endl;
+}
\ No newline at end of file
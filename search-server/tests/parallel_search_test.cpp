@@ -0,0 +1,73 @@
+// проверка FindTopDocuments(std::execution::par) против последовательной версии: параллельный обход
+// делит индекс на диапазоны документов и сливает их топы, а выдача должна совпадать до бита и порядка.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/parallel_search_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o parallel_search_test
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+// несколько диапазонов параллельного обхода и слова, встречающиеся почти в каждом из них
+constexpr size_t DOCUMENT_COUNT = 40000;
+constexpr unsigned VOCABULARY_SIZE = 3000;
+
+int CheckQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
+    int mismatch_count = 0;
+    const auto check = [&mismatch_count](const std::vector<Document>& expected, const std::vector<Document>& actual,
+                                         const std::string& description) {
+        mismatch_count += !IsIdenticalResult(expected, actual, description);
+    };
+    for (const std::string& query : queries) {
+        for (const size_t top_k : {size_t{1}, size_t{5}, size_t{37}, size_t{150}, size_t{5000}}) {
+            const std::string description = "'" + query + "', top " + std::to_string(top_k);
+            check(search_server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, top_k),
+                  search_server.FindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL, top_k),
+                  description);
+            check(search_server.FindTopDocuments(std::execution::seq, query, DocumentStatus::BANNED, top_k),
+                  search_server.FindTopDocuments(std::execution::par, query, DocumentStatus::BANNED, top_k),
+                  description + ", BANNED");
+            check(search_server.FindTopDocuments(std::execution::seq, query, RatingAboveFilter{0}, top_k),
+                  search_server.FindTopDocuments(std::execution::par, query, RatingAboveFilter{0}, top_k),
+                  description + ", rating above 0");
+            const auto is_even = [](int document_id, DocumentStatus status, int) {
+                return document_id % 2 == 0 && status != DocumentStatus::REMOVED;
+            };
+            check(search_server.FindTopDocuments(std::execution::seq, query, is_even, top_k),
+                  search_server.FindTopDocuments(std::execution::par, query, is_even, top_k),
+                  description + ", lambda");
+        }
+    }
+    return mismatch_count;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(1);
+    SearchServer search_server("and in"s);
+    const std::vector<TestDocument> documents = GenerateTestDocuments(generator, DOCUMENT_COUNT, VOCABULARY_SIZE);
+    for (const TestDocument& document : documents) {
+        search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 150, VOCABULARY_SIZE);
+
+    int mismatch_count = CheckQueries(search_server, queries);
+    // удалённые документы оставляют пропуски в номерах, в том числе на границах диапазонов
+    for (size_t i = 0; i < documents.size(); i += 7) {
+        search_server.RemoveDocument(documents[i].id);
+    }
+    mismatch_count += CheckQueries(search_server, queries);
+    search_server.SetPostingListLayout(SearchServer::PostingListLayout::COMPRESSED);
+    mismatch_count += CheckQueries(search_server, queries);
+    if (mismatch_count > 0) {
+        std::cerr << mismatch_count << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << queries.size() << " queries, par matches seq" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+// проверка сжатых списков документов: CompressedPostingList против обычного массива при удалениях в начале,
+// на границах блоков и в конце, и SearchServer со сжатыми списками против такого же с обычными -
+// выдачи совпадают до бита и порядка, в том числе после RemoveDocument и последующих добавлений.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/posting_list_layout_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o posting_list_layout_test
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../compressed_posting_list.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 1500;
+
+// список сверяется с ожидаемыми номерами и числами вхождений: распаковка, Contains и обход курсором
+bool IsSameList(const CompressedPostingList& posting_list, const std::vector<int>& expected_documents,
+                const std::vector<uint32_t>& expected_counts, std::mt19937& generator) {
+    std::vector<int> documents;
+    std::vector<uint32_t> term_counts;
+    posting_list.Decode(documents, term_counts);
+    if (documents != expected_documents || term_counts != expected_counts
+        || posting_list.size() != expected_documents.size()) {
+        return false;
+    }
+    const int last = expected_documents.empty() ? 0 : expected_documents.back();
+    CompressedPostingList::Cursor cursor(posting_list);
+    for (int document = 0; document <= last + 1; document += 1 + static_cast<int>(generator() % 300)) {
+        const bool is_present = std::binary_search(expected_documents.begin(), expected_documents.end(), document);
+        if (posting_list.Contains(document) != is_present || cursor.SkipTo(document) != is_present) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int CheckCompressedPostingList(std::mt19937& generator) {
+    CompressedPostingList posting_list;
+    std::vector<int> documents;
+    std::vector<uint32_t> term_counts;
+    int document = 0;
+    for (size_t i = 0; i < 10 * CompressedPostingList::BLOCK_SIZE; ++i) {
+        // разности разной длины в varint: от одного до трёх байт
+        document += 1 + static_cast<int>(generator() % (i % 3 == 0 ? 20000 : 100));
+        const uint32_t term_count = 1 + generator() % (i % 5 == 0 ? 1000 : 3);
+        posting_list.Append(document, term_count);
+        documents.push_back(document);
+        term_counts.push_back(term_count);
+    }
+    int failure_count = !IsSameList(posting_list, documents, term_counts, generator);
+    // первый, последний, по обе стороны границ блоков и случайные
+    std::vector<size_t> positions = {0, documents.size() - 1};
+    for (size_t block = 1; block < 9; block += 3) {
+        positions.push_back(block * CompressedPostingList::BLOCK_SIZE - 1);
+        positions.push_back(block * CompressedPostingList::BLOCK_SIZE);
+    }
+    for (int i = 0; i < 40; ++i) {
+        positions.push_back(generator() % documents.size());
+    }
+    for (const size_t position : positions) {
+        if (position >= documents.size()) {
+            continue;
+        }
+        posting_list.Erase(documents[position]);
+        documents.erase(documents.begin() + position);
+        term_counts.erase(term_counts.begin() + position);
+        if (!IsSameList(posting_list, documents, term_counts, generator)) {
+            ++failure_count;
+            std::cerr << "compressed list differs after erasing position " << position << std::endl;
+        }
+    }
+    // отсутствующий документ не меняет список
+    posting_list.Erase(documents.back() + 1);
+    failure_count += !IsSameList(posting_list, documents, term_counts, generator);
+    while (!documents.empty()) {
+        posting_list.Erase(documents.back());
+        documents.pop_back();
+        term_counts.pop_back();
+    }
+    failure_count += !IsSameList(posting_list, documents, term_counts, generator) || !posting_list.empty();
+    return failure_count;
+}
+
+int CompareLayouts(const SearchServer& plain, const std::vector<const SearchServer*>& compressed,
+                   const std::vector<std::string>& queries) {
+    int mismatch_count = 0;
+    for (const SearchServer* search_server : compressed) {
+        for (const std::string& query : queries) {
+            for (const size_t top_k : {size_t{1}, size_t{5}, size_t{120}, size_t{10000}}) {
+                mismatch_count += !IsIdenticalResult(plain.FindTopDocuments(query, DocumentStatus::ACTUAL, top_k),
+                                                     search_server->FindTopDocuments(query, DocumentStatus::ACTUAL,
+                                                                                     top_k),
+                                                     "'" + query + "', top " + std::to_string(top_k));
+            }
+            mismatch_count += !IsIdenticalResult(
+                    plain.FindTopDocuments(std::execution::par, query, RatingAboveFilter{0}),
+                    search_server->FindTopDocuments(std::execution::par, query, RatingAboveFilter{0}),
+                    "'" + query + "', par");
+            mismatch_count += !IsIdenticalResult(plain.OpenCursor(query).GetPage(0, 1000),
+                                                 search_server->OpenCursor(query).GetPage(0, 1000),
+                                                 "'" + query + "', cursor");
+        }
+        for (const int document_id : plain) {
+            if (plain.GetWordFrequencies(document_id) != search_server->GetWordFrequencies(document_id)) {
+                ++mismatch_count;
+                std::cerr << "word frequencies of " << document_id << " differ" << std::endl;
+            }
+        }
+    }
+    return mismatch_count;
+}
+
+} // namespace
+
+int main() {
+    using Layout = SearchServer::PostingListLayout;
+    std::mt19937 generator(11);
+    int failure_count = CheckCompressedPostingList(generator);
+
+    const std::vector<TestDocument> documents = GenerateTestDocuments(generator, 20000, VOCABULARY_SIZE);
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 150, VOCABULARY_SIZE);
+    // сжатые списки с первого документа и после переключения заполненного индекса
+    SearchServer plain("and in"s);
+    SearchServer compressed("and in"s);
+    SearchServer switched("and in"s);
+    compressed.SetPostingListLayout(Layout::COMPRESSED);
+    const auto add = [&](const TestDocument& document) {
+        for (SearchServer* search_server : {&plain, &compressed, &switched}) {
+            search_server->AddDocument(document.id, document.text, document.status, document.ratings);
+        }
+    };
+    for (size_t i = 0; i < documents.size() / 2; ++i) {
+        add(documents[i]);
+    }
+    switched.SetPostingListLayout(Layout::COMPRESSED);
+    for (size_t i = documents.size() / 2; i < documents.size(); ++i) {
+        add(documents[i]);
+    }
+    failure_count += CompareLayouts(plain, {&compressed, &switched}, queries);
+
+    // удаление перепаковывает сжатый список с блока документа: удаляются документы подряд, через один
+    // и случайные, затем добавляются новые в конец списков
+    for (size_t i = 0; i < 300; ++i) {
+        const int document_id = documents[i < 100 ? i : i < 200 ? 2 * i : generator() % documents.size()].id;
+        for (SearchServer* search_server : {&plain, &compressed, &switched}) {
+            search_server->RemoveDocument(document_id);
+        }
+    }
+    failure_count += CompareLayouts(plain, {&compressed, &switched}, queries);
+    for (TestDocument document : GenerateTestDocuments(generator, 2000, VOCABULARY_SIZE)) {
+        document.id += 1000000;
+        add(document);
+    }
+    failure_count += CompareLayouts(plain, {&compressed, &switched}, queries);
+    // обратно к обычным спискам
+    switched.SetPostingListLayout(Layout::PLAIN);
+    failure_count += CompareLayouts(plain, {&switched}, queries);
+
+    if (failure_count > 0) {
+        std::cerr << failure_count << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: compressed posting lists match plain ones" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+// проверка ProcessQueries и ProcessQueriesJoined: результаты пакета совпадают с поиском по одному запросу,
+// а некорректный запрос в пакете даёт исключение invalid_argument, а не завершение программы.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/process_queries_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o process_queries_test
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../process_queries.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 500;
+
+// true, если обработка пакета выбросила invalid_argument
+template <typename Function>
+bool ThrowsInvalidArgument(Function function) {
+    try {
+        function();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(5);
+    SearchServer search_server("and in"s);
+    for (const TestDocument& document : GenerateTestDocuments(generator, 5000, VOCABULARY_SIZE)) {
+        search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 500, VOCABULARY_SIZE);
+
+    int mismatch_count = 0;
+    const std::vector<std::vector<Document>> results = ProcessQueries(search_server, queries);
+    std::vector<Document> expected_joined;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const std::vector<Document> expected = search_server.FindTopDocuments(queries[i]);
+        mismatch_count += !IsIdenticalResult(expected, results[i], "'" + queries[i] + "'");
+        expected_joined.insert(expected_joined.end(), expected.begin(), expected.end());
+    }
+    const JoinedDocuments joined = ProcessQueriesJoined(search_server, queries);
+    const std::vector<Document> actual_joined(joined.begin(), joined.end());
+    mismatch_count += !IsIdenticalResult(expected_joined, actual_joined, "joined results");
+
+    // некорректные запросы в начале, в середине и в конце пакета
+    int missed_error_count = 0;
+    for (const size_t position : {size_t{0}, queries.size() / 2, queries.size()}) {
+        for (const std::string& bad_query : {"cat --bad"s, "cat -"s, "w1 w\x01"s}) {
+            std::vector<std::string> batch = queries;
+            batch.insert(batch.begin() + position, bad_query);
+            if (!ThrowsInvalidArgument([&] { ProcessQueries(search_server, batch); })
+                || !ThrowsInvalidArgument([&] { ProcessQueriesJoined(search_server, batch); })) {
+                ++missed_error_count;
+                std::cerr << "no invalid_argument for '" << bad_query << "' at " << position << std::endl;
+            }
+        }
+    }
+    if (mismatch_count > 0 || missed_error_count > 0) {
+        std::cerr << mismatch_count << " mismatches, " << missed_error_count << " missed errors" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << queries.size() << " queries" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+// проверка обхода с отсечением MaxScore: топ FindTopDocuments многословного запроса совпадает до бита и порядка
+// с началом полной выдачи, посчитанной без отсечения плотным массивом релевантностей (OpenCursor).
+// Запросы с минус-словами, фильтрами атрибутов и произвольным предикатом, при разных top_k,
+// для обычных и сжатых списков документов. Счётчики SearchProfiler подтверждают, что отсечение было.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/pruning_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o pruning_test
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../search_profiler.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 3000;
+// документы из двух разных слов маленького словаря: у каждого слова TF 0.5, равная оценке сверху,
+// поэтому много документов с релевантностью, в точности равной границе отбора
+constexpr unsigned SMALL_VOCABULARY_SIZE = 30;
+
+// топ с отсечением против первых top_k документов полной выдачи с тем же предикатом
+template <typename Predicate>
+int CheckQuery(const SearchServer& search_server, const std::string& query, Predicate predicate,
+               const std::string& predicate_name) {
+    int mismatch_count = 0;
+    const std::vector<Document> all_documents = search_server.OpenCursor(query, predicate).GetPage(0, 100);
+    for (const size_t top_k : {size_t{1}, size_t{2}, size_t{5}, size_t{10}, size_t{33}, size_t{100}}) {
+        const std::vector<Document> expected(all_documents.begin(),
+                                             all_documents.begin() + std::min(top_k, all_documents.size()));
+        mismatch_count += !IsIdenticalResult(expected, search_server.FindTopDocuments(query, predicate, top_k),
+                                             "'" + query + "', " + predicate_name + ", top " + std::to_string(top_k));
+    }
+    return mismatch_count;
+}
+
+int CheckQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
+    int mismatch_count = 0;
+    for (const std::string& query : queries) {
+        mismatch_count += CheckQuery(search_server, query, StatusFilter{DocumentStatus::ACTUAL}, "ACTUAL");
+        mismatch_count += CheckQuery(search_server, query, StatusFilter{DocumentStatus::BANNED}, "BANNED");
+        mismatch_count += CheckQuery(search_server, query, RatingAboveFilter{1}, "rating above 1");
+        mismatch_count += CheckQuery(search_server, query, DocumentIdRangeFilter{10000, 50000}, "id range");
+        mismatch_count += CheckQuery(search_server, query, [](int document_id, DocumentStatus status, int rating) {
+            return document_id % 3 != 0 && status != DocumentStatus::REMOVED && rating >= 0;
+        }, "lambda");
+    }
+    return mismatch_count;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(12);
+    SearchServer search_server("and in"s);
+    const std::vector<TestDocument> documents = GenerateTestDocuments(generator, 30000, VOCABULARY_SIZE);
+    for (const TestDocument& document : documents) {
+        search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    // только многословные запросы: однословные идут мимо обхода с отсечением
+    std::vector<std::string> queries;
+    for (const std::string& query : GenerateTestQueries(generator, 400, VOCABULARY_SIZE)) {
+        queries.push_back(query + ' ' + MakeTestWord(generator, VOCABULARY_SIZE));
+    }
+
+    SearchProfiler::Reset();
+    SearchProfiler::Enable();
+    int mismatch_count = CheckQueries(search_server, queries);
+    // после удалений оценки сверху max_term_freq остаются прежними и становятся неточными
+    for (size_t i = 0; i < documents.size(); i += 4) {
+        search_server.RemoveDocument(documents[i].id);
+    }
+    mismatch_count += CheckQueries(search_server, queries);
+    search_server.SetPostingListLayout(SearchServer::PostingListLayout::COMPRESSED);
+    mismatch_count += CheckQueries(search_server, queries);
+
+    SearchServer tied_server("and in"s);
+    for (int document_id = 0; document_id < 20000; ++document_id) {
+        const unsigned first_word = generator() % SMALL_VOCABULARY_SIZE;
+        const unsigned second_word = (first_word + 1 + generator() % (SMALL_VOCABULARY_SIZE - 1))
+                                     % SMALL_VOCABULARY_SIZE;
+        tied_server.AddDocument(document_id, "w" + std::to_string(first_word) + " w" + std::to_string(second_word),
+                                DocumentStatus::ACTUAL, {static_cast<int>(generator() % 3)});
+    }
+    std::vector<std::string> tied_queries;
+    for (const std::string& query : GenerateTestQueries(generator, 200, SMALL_VOCABULARY_SIZE)) {
+        tied_queries.push_back(query + ' ' + MakeTestWord(generator, SMALL_VOCABULARY_SIZE));
+    }
+    mismatch_count += CheckQueries(tied_server, tied_queries);
+    SearchProfiler::Disable();
+
+    const SearchProfiler::PruningStats stats = SearchProfiler::GetPruningStats();
+    if (stats.query_count == 0 || stats.pruned_count == 0) {
+        std::cerr << "no documents were pruned, the check did not exercise MaxScore" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (mismatch_count > 0) {
+        std::cerr << mismatch_count << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << stats.query_count << " pruned searches, " << stats.pruned_count << " of "
+              << stats.candidate_count << " candidates pruned" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+// проверка QueryCache: выдача совпадает с FindTopDocuments, запросы с одним каноническим видом делят запись,
+// изменение индекса делает запись промахом, а новая запись заменяет её; число записей не превышает
+// ёмкость при любом числе корзин, и кэш без корзин не создаётся.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/query_cache_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o query_cache_test
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../query_cache.h"
+#include "../search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 500;
+
+// после заполнения кэша запросами queries повторный проход попадает не больше чем в capacity записей
+bool IsWithinCapacity(const SearchServer& search_server, const std::vector<std::string>& queries, size_t capacity,
+                      size_t bucket_count) {
+    QueryCache cache(capacity, bucket_count);
+    for (const std::string& query : queries) {
+        cache.FindTopDocuments(search_server, query);
+    }
+    for (const std::string& query : queries) {
+        cache.FindTopDocuments(search_server, query);
+    }
+    if (cache.GetHitCount() > capacity) {
+        std::cerr << "capacity " << capacity << " with " << bucket_count << " buckets kept " << cache.GetHitCount()
+                  << " entries" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(13);
+    SearchServer search_server("and in"s);
+    for (const TestDocument& document : GenerateTestDocuments(generator, 5000, VOCABULARY_SIZE)) {
+        search_server.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 300, VOCABULARY_SIZE);
+    int failure_count = 0;
+
+    QueryCache cache;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const std::string& query : queries) {
+            for (const DocumentStatus status : {DocumentStatus::ACTUAL, DocumentStatus::BANNED}) {
+                failure_count += !IsIdenticalResult(search_server.FindTopDocuments(query, status, 7),
+                                                    cache.FindTopDocuments(search_server, query, status, 7),
+                                                    "'" + query + "'");
+            }
+        }
+    }
+    // во втором проходе попадают все запросы, кроме повторов с тем же каноническим видом в первом
+    if (cache.GetHitCount() < queries.size() * 2) {
+        ++failure_count;
+        std::cerr << "second pass hit " << cache.GetHitCount() << " times" << std::endl;
+    }
+
+    const uint64_t hits_before = cache.GetHitCount();
+    cache.FindTopDocuments(search_server, "w1 w2 -w3");
+    cache.FindTopDocuments(search_server, "-w3 w2 w1 w2 and");
+    if (cache.GetHitCount() != hits_before + 1) {
+        ++failure_count;
+        std::cerr << "equal normalized queries do not share an entry" << std::endl;
+    }
+
+    // после изменения индекса запись устарела: промах с новой выдачей, затем попадание в заменившую её запись
+    search_server.AddDocument(1000000, "w1 w2 w2 w2", DocumentStatus::ACTUAL, {100});
+    const uint64_t misses_before = cache.GetMissCount();
+    failure_count += !IsIdenticalResult(search_server.FindTopDocuments("w1 w2 -w3"),
+                                        cache.FindTopDocuments(search_server, "w1 w2 -w3"), "after AddDocument");
+    failure_count += !IsIdenticalResult(search_server.FindTopDocuments("w1 w2 -w3"),
+                                        cache.FindTopDocuments(search_server, "w1 w2 -w3"), "after AddDocument");
+    if (cache.GetMissCount() != misses_before + 1 || cache.GetHitCount() != hits_before + 2) {
+        ++failure_count;
+        std::cerr << "stale entry was not replaced" << std::endl;
+    }
+
+    for (const auto& [capacity, bucket_count] : {std::pair{1, 16}, std::pair{10, 16}, std::pair{17, 16},
+                                                 std::pair{100, 7}, std::pair{0, 16}}) {
+        failure_count += !IsWithinCapacity(search_server, queries, capacity, bucket_count);
+    }
+    try {
+        QueryCache invalid_cache(10, 0);
+        ++failure_count;
+        std::cerr << "cache without buckets was created" << std::endl;
+    } catch (const std::invalid_argument&) {
+    }
+
+    if (failure_count > 0) {
+        std::cerr << failure_count << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << cache.GetHitCount() << " hits, " << cache.GetMissCount() << " misses" << std::endl;
+}
\ No newline at end of file
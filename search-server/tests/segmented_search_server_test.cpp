@@ -0,0 +1,136 @@
+// проверка SegmentedSearchServer против одного SearchServer с тем же корпусом: поиск во время фонового
+// слияния, из сливаемых сегментов которого удалены документы, должен давать те же документы и релевантности.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/segmented_search_server_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o segmented_search_server_test
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../search_server.h"
+#include "../segmented_search_server.h"
+
+namespace {
+
+constexpr size_t SEAL_THRESHOLD = 30000;
+constexpr int ATTEMPT_COUNT = 20;
+
+struct TestDocument {
+    int id;
+    std::string text;
+    std::vector<int> ratings;
+};
+
+std::vector<TestDocument> GenerateDocuments(std::mt19937& generator, int first_id, size_t count) {
+    std::vector<TestDocument> documents;
+    for (size_t i = 0; i < count; ++i) {
+        std::string text;
+        const int word_count = 3 + static_cast<int>(generator() % 10);
+        for (int j = 0; j < word_count; ++j) {
+            // частые и редкие слова: у редких df заметно меняется от удаления нескольких документов
+            const unsigned rank = std::min(generator() % 2000, generator() % 2000);
+            text += "w" + std::to_string(rank) + ' ';
+        }
+        documents.push_back({first_id + static_cast<int>(i), text, {static_cast<int>(generator() % 1000)}});
+    }
+    return documents;
+}
+
+// порядок документов с равными релевантностью и рейтингом не определён, поэтому сравниваются
+// релевантности (до бита) и рейтинги по позициям, а id - только там, где у соседей нет такой же пары.
+// Последний документ топа может делить место с не попавшим в топ, и его id не сравнивается
+bool IsSameResult(const std::vector<Document>& expected, const std::vector<Document>& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    const auto is_same_rank = [&expected](size_t i, size_t j) {
+        return expected[i].relevance == expected[j].relevance && expected[i].rating == expected[j].rating;
+    };
+    const auto has_tie = [&](size_t i) {
+        return i + 1 == expected.size() || is_same_rank(i, i + 1) || (i > 0 && is_same_rank(i, i - 1));
+    };
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].relevance != actual[i].relevance || expected[i].rating != actual[i].rating) {
+            return false;
+        }
+        if (expected[i].id != actual[i].id && !has_tie(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true, если запросы удалось выполнить, пока слияние с отложенными удалениями ещё шло
+bool RunAttempt(std::mt19937& generator, const std::vector<std::string>& queries, int& mismatch_count) {
+    SearchServer reference("and in"s);
+    SegmentedSearchServer segmented("and in"s, SEAL_THRESHOLD, 2);
+    // два запечатанных сегмента одного уровня - и фоновый поток начинает их сливать
+    for (const TestDocument& document : GenerateDocuments(generator, 0, 2 * SEAL_THRESHOLD)) {
+        reference.AddDocument(document.id, document.text, DocumentStatus::ACTUAL, document.ratings);
+        segmented.AddDocument(document.id, document.text, DocumentStatus::ACTUAL, document.ratings);
+    }
+    while (!segmented.IsMergeRunning()) {
+        std::this_thread::yield();
+    }
+    // удаления из сливаемых сегментов откладываются; один документ добавляется заново под тем же id
+    for (int i = 0; i < 8; ++i) {
+        const int document_id = static_cast<int>(generator() % (2 * SEAL_THRESHOLD));
+        reference.RemoveDocument(document_id);
+        segmented.RemoveDocument(document_id);
+        if (i == 0) {
+            const std::string text = "w0 w1 w1999 fresh";
+            reference.AddDocument(document_id, text, DocumentStatus::ACTUAL, {5});
+            segmented.AddDocument(document_id, text, DocumentStatus::ACTUAL, {5});
+        }
+    }
+    for (const std::string& query : queries) {
+        if (!IsSameResult(reference.FindTopDocuments(query), segmented.FindTopDocuments(query))) {
+            ++mismatch_count;
+            std::cerr << "mismatch on query '" << query << "'" << std::endl;
+        }
+    }
+    const bool is_merge_checked = segmented.IsMergeRunning();
+    segmented.WaitForMerges();
+    for (const std::string& query : queries) {
+        if (!IsSameResult(reference.FindTopDocuments(query), segmented.FindTopDocuments(query))) {
+            ++mismatch_count;
+            std::cerr << "mismatch after merge on query '" << query << "'" << std::endl;
+        }
+    }
+    return is_merge_checked;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(17);
+    std::vector<std::string> queries;
+    for (int i = 0; i < 200; ++i) {
+        std::string query;
+        for (int j = 0; j < 1 + i % 4; ++j) {
+            query += "w" + std::to_string(std::min(generator() % 2000, generator() % 2000)) + ' ';
+        }
+        if (i % 5 == 0) {
+            query += "-w" + std::to_string(generator() % 50);
+        }
+        queries.push_back(query);
+    }
+    queries.push_back("fresh");
+
+    int mismatch_count = 0;
+    int checked_attempt_count = 0;
+    for (int attempt = 0; attempt < ATTEMPT_COUNT && checked_attempt_count < 3; ++attempt) {
+        checked_attempt_count += RunAttempt(generator, queries, mismatch_count);
+    }
+    if (checked_attempt_count == 0) {
+        std::cerr << "merge finished before the queries in every attempt" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (mismatch_count > 0) {
+        std::cerr << mismatch_count << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: " << checked_attempt_count << " runs queried during a merge" << std::endl;
+}
\ No newline at end of file
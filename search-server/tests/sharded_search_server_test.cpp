@@ -0,0 +1,137 @@
+// проверка ShardedSearchServer: при разном числе шардов выдача FindTopDocuments и MatchDocument совпадает
+// до бита и порядка с одним SearchServer с теми же документами - после поштучного и пакетного добавления,
+// после удалений и при запросах из нескольких потоков одновременно. Исключение предиката доходит до вызывающего.
+// Сборка из каталога search-server:
+//   g++ -std=c++17 -O2 -I. tests/sharded_search_server_test.cpp $(ls *.cpp | grep -v '^main.cpp$') -ltbb -lpthread -o sharded_search_server_test
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../search_server.h"
+#include "../sharded_search_server.h"
+#include "test_corpus.h"
+
+namespace {
+
+constexpr unsigned VOCABULARY_SIZE = 1000;
+constexpr int THREAD_COUNT = 4;
+
+int CompareWithMonolithic(const SearchServer& reference, const ShardedSearchServer& sharded,
+                          const std::vector<std::string>& queries, const std::vector<int>& document_ids) {
+    int mismatch_count = 0;
+    if (reference.GetDocumentCount() != sharded.GetDocumentCount()) {
+        ++mismatch_count;
+        std::cerr << "document counts differ" << std::endl;
+    }
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const std::string& query = queries[i];
+        for (const size_t top_k : {size_t{1}, size_t{5}, size_t{100}}) {
+            mismatch_count += !IsIdenticalResult(reference.FindTopDocuments(query, DocumentStatus::ACTUAL, top_k),
+                                                 sharded.FindTopDocuments(query, DocumentStatus::ACTUAL, top_k),
+                                                 "'" + query + "', top " + std::to_string(top_k));
+        }
+        mismatch_count += !IsIdenticalResult(reference.FindTopDocuments(query, DocumentStatus::BANNED),
+                                             sharded.FindTopDocuments(query, DocumentStatus::BANNED),
+                                             "'" + query + "', BANNED");
+        const auto predicate = [](int document_id, DocumentStatus, int rating) {
+            return document_id % 2 == 0 || rating > 1;
+        };
+        mismatch_count += !IsIdenticalResult(reference.FindTopDocuments(query, predicate),
+                                             sharded.FindTopDocuments(query, predicate), "'" + query + "', lambda");
+        const int document_id = document_ids[i * 7919 % document_ids.size()];
+        if (reference.MatchDocument(query, document_id) != sharded.MatchDocument(query, document_id)) {
+            ++mismatch_count;
+            std::cerr << "MatchDocument('" << query << "', " << document_id << ") differs" << std::endl;
+        }
+    }
+    return mismatch_count;
+}
+
+// те же запросы из нескольких потоков сразу; выдача сверяется с одним SearchServer после завершения потоков
+int CompareConcurrently(const SearchServer& reference, const ShardedSearchServer& sharded,
+                        const std::vector<std::string>& queries) {
+    std::vector<std::vector<Document>> results(queries.size() * 3);
+    std::vector<std::thread> threads;
+    for (int thread_index = 0; thread_index < THREAD_COUNT; ++thread_index) {
+        threads.emplace_back([&, thread_index] {
+            for (size_t i = thread_index; i < results.size(); i += THREAD_COUNT) {
+                results[i] = sharded.FindTopDocuments(queries[i % queries.size()]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    int mismatch_count = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const std::string& query = queries[i % queries.size()];
+        mismatch_count += !IsIdenticalResult(reference.FindTopDocuments(query), results[i],
+                                             "'" + query + "', concurrent");
+    }
+    return mismatch_count;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 generator(18);
+    const std::vector<TestDocument> documents = GenerateTestDocuments(generator, 15000, VOCABULARY_SIZE);
+    const std::vector<std::string> queries = GenerateTestQueries(generator, 150, VOCABULARY_SIZE);
+    int failure_count = 0;
+
+    for (const size_t shard_count : {size_t{1}, size_t{3}, size_t{8}}) {
+        SearchServer reference("and in"s);
+        ShardedSearchServer sharded("and in"s, shard_count);
+        std::vector<int> document_ids;
+        // первая половина поштучно, вторая пакетами
+        const size_t half = documents.size() / 2;
+        for (size_t i = 0; i < half; ++i) {
+            const TestDocument& document = documents[i];
+            reference.AddDocument(document.id, document.text, document.status, document.ratings);
+            sharded.AddDocument(document.id, document.text, document.status, document.ratings);
+            document_ids.push_back(document.id);
+        }
+        for (size_t first = half; first < documents.size(); first += 1000) {
+            std::vector<SearchServer::DocumentToAdd> batch;
+            for (size_t i = first; i < std::min(first + 1000, documents.size()); ++i) {
+                const TestDocument& document = documents[i];
+                reference.AddDocument(document.id, document.text, document.status, document.ratings);
+                batch.push_back({document.id, document.text, document.status, document.ratings});
+                document_ids.push_back(document.id);
+            }
+            sharded.AddDocuments(batch);
+        }
+        failure_count += CompareWithMonolithic(reference, sharded, queries, document_ids);
+        failure_count += CompareConcurrently(reference, sharded, queries);
+
+        // удаления меняют IDF во всех шардах
+        std::vector<int> remaining_ids;
+        for (size_t i = 0; i < document_ids.size(); ++i) {
+            if (i % 3 == 0) {
+                reference.RemoveDocument(document_ids[i]);
+                sharded.RemoveDocument(document_ids[i]);
+            } else {
+                remaining_ids.push_back(document_ids[i]);
+            }
+        }
+        failure_count += CompareWithMonolithic(reference, sharded, queries, remaining_ids);
+
+        try {
+            sharded.FindTopDocuments(queries[0] + " w1", [](int, DocumentStatus, int) -> bool {
+                throw std::runtime_error("predicate failed");
+            });
+            ++failure_count;
+            std::cerr << "predicate exception was lost with " << shard_count << " shards" << std::endl;
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    if (failure_count > 0) {
+        std::cerr << failure_count << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK: 1, 3 and 8 shards match a single SearchServer" << std::endl;
+}
\ No newline at end of file
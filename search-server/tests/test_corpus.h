@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../document.h"
+
+// общее для проверок: случайный корпус, запросы к нему и точное сравнение выдач
+
+struct TestDocument {
+    int id;
+    std::string text;
+    DocumentStatus status;
+    std::vector<int> ratings;
+};
+
+// слово ранга rank; частота ранга убывает примерно как у естественного языка: min из двух равномерных
+inline std::string MakeTestWord(std::mt19937& generator, unsigned vocabulary_size) {
+    return "w" + std::to_string(std::min(generator() % vocabulary_size, generator() % vocabulary_size));
+}
+
+// id идут с шагом, чтобы не совпадать с внутренними номерами; рейтинги из небольшого диапазона,
+// чтобы были документы с равными релевантностью и рейтингом
+inline std::vector<TestDocument> GenerateTestDocuments(std::mt19937& generator, size_t count,
+                                                       unsigned vocabulary_size) {
+    std::vector<TestDocument> documents;
+    for (size_t i = 0; i < count; ++i) {
+        std::string text;
+        const int word_count = 1 + static_cast<int>(generator() % 12);
+        for (int j = 0; j < word_count; ++j) {
+            text += MakeTestWord(generator, vocabulary_size) + ' ';
+        }
+        const auto status = static_cast<DocumentStatus>(generator() % 8 == 0 ? generator() % 4 : 0);
+        std::vector<int> ratings;
+        for (unsigned j = generator() % 3; j > 0; --j) {
+            ratings.push_back(static_cast<int>(generator() % 7) - 2);
+        }
+        documents.push_back({static_cast<int>(i * 3 + 1), text, status, ratings});
+    }
+    return documents;
+}
+
+// запросы из 1-6 слов, часть с минус-словами и со стоп-словом "and"
+inline std::vector<std::string> GenerateTestQueries(std::mt19937& generator, size_t count, unsigned vocabulary_size) {
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < count; ++i) {
+        std::string query;
+        for (int j = 1 + static_cast<int>(generator() % 6); j > 0; --j) {
+            query += MakeTestWord(generator, vocabulary_size) + ' ';
+        }
+        if (generator() % 3 == 0) {
+            query += "-" + MakeTestWord(generator, vocabulary_size) + ' ';
+        }
+        if (generator() % 5 == 0) {
+            query += "and";
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+// выдачи совпадают до бита релевантности и порядка документов; при расхождении печатает его в std::cerr
+inline bool IsIdenticalResult(const std::vector<Document>& expected, const std::vector<Document>& actual,
+                              std::string_view description) {
+    const bool is_identical = std::equal(expected.begin(), expected.end(), actual.begin(), actual.end(),
+                                         [](const Document& lhs, const Document& rhs) {
+                                             return lhs.id == rhs.id && lhs.relevance == rhs.relevance
+                                                    && lhs.rating == rhs.rating;
+                                         });
+    if (!is_identical) {
+        std::cerr << "mismatch on " << description << ":" << std::endl << "  expected";
+        for (const Document& document : expected) {
+            std::cerr << ' ' << document;
+        }
+        std::cerr << std::endl << "  actual  ";
+        for (const Document& document : actual) {
+            std::cerr << ' ' << document;
+        }
+        std::cerr << std::endl;
+    }
+    return is_identical;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "top_documents.h"
+#include "search_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+bool IsMoreRelevant(const Document& lhs, const Document& rhs) {
+    if (std::abs(lhs.relevance - rhs.relevance) < std::numeric_limits<double>::epsilon()) {
+        if (lhs.rating != rhs.rating) {
+            return lhs.rating > rhs.rating;
+        }
+        return lhs.id < rhs.id;
+    }
+    return lhs.relevance > rhs.relevance;
+}
+
+TopDocuments::TopDocuments(size_t max_count)
+        : max_count_(max_count) {
+    heap_.reserve(max_count_);
+}
+
+void TopDocuments::Add(const Document& document) {
+    if (heap_.size() < max_count_) {
+        heap_.push_back(document);
+        std::push_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+        return;
+    }
+    // при IsMoreRelevant в роли "меньше" на вершине кучи оказывается наименее релевантный документ
+    if (max_count_ == 0 || !IsMoreRelevant(document, heap_.front())) {
+        return;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+    heap_.back() = document;
+    std::push_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+}
+
+double TopDocuments::GetThreshold() const {
+    if (max_count_ == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (heap_.size() < max_count_) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return heap_.front().relevance;
+}
+
+std::vector<Document> TopDocuments::Extract() {
+    PROFILE_SEARCH_STAGE(SearchStage::SORT);
+    std::sort_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+    return std::move(heap_);
+}
+
+
+std::vector<Document> MergeTopDocuments(const std::vector<std::vector<Document>>& sorted_lists, size_t top_k) {
+    // голова списка: номер списка и позиция в нём
+    using Head = std::pair<size_t, size_t>;
+    // на вершине кучи - лучшая из голов
+    const auto is_worse_head = [&sorted_lists](const Head& lhs, const Head& rhs) {
+        const Document& lhs_document = sorted_lists[lhs.first][lhs.second];
+        const Document& rhs_document = sorted_lists[rhs.first][rhs.second];
+        if (IsMoreRelevant(rhs_document, lhs_document)) {
+            return true;
+        }
+        return !IsMoreRelevant(lhs_document, rhs_document) && lhs.first > rhs.first;
+    };
+    std::vector<Head> heads;
+    for (size_t i = 0; i < sorted_lists.size(); ++i) {
+        if (!sorted_lists[i].empty()) {
+            heads.emplace_back(i, 0);
+        }
+    }
+    std::make_heap(heads.begin(), heads.end(), is_worse_head);
+    std::vector<Document> documents;
+    while (documents.size() < top_k && !heads.empty()) {
+        std::pop_heap(heads.begin(), heads.end(), is_worse_head);
+        Head& head = heads.back();
+        documents.push_back(sorted_lists[head.first][head.second]);
+        if (++head.second < sorted_lists[head.first].size()) {
+            std::push_heap(heads.begin(), heads.end(), is_worse_head);
+        } else {
+            heads.pop_back();
+        }
+    }
+    return documents;
+}
\ No newline at end of file
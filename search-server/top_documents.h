@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "document.h"
+
+// порядок выдачи: по убыванию релевантности, при равной (с точностью до эпсилон) релевантности - по убыванию рейтинга,
+// а при равном рейтинге - по возрастанию id. Порядок полный, поэтому топ не зависит от того, в каком порядке
+// и каким путём (с отсечением, по диапазонам, по сегментам) документы прошли отбор
+bool IsMoreRelevant(const Document& lhs, const Document& rhs);
+
+// потоковый отбор K лучших документов: куча ограниченного размера, на вершине которой
+// худший из уже отобранных. Добавление стоит O(log K), а не сортировку всех найденных
+class TopDocuments {
+public:
+    explicit TopDocuments(size_t max_count);
+
+    void Add(const Document& document);
+
+    // релевантность худшего из отобранных, если отобрано уже max_count документов, иначе -inf.
+    // Документ с релевантностью ниже этой границы (больше чем на эпсилон) в отбор не попадёт
+    double GetThreshold() const;
+
+    // отобранные документы, отсортированные от лучшего к худшему
+    std::vector<Document> Extract();
+
+private:
+    size_t max_count_;
+    std::vector<Document> heap_;
+};
+
+// k-путевое слияние списков, каждый из которых отсортирован по IsMoreRelevant, в top_k лучших:
+// куча из текущих голов списков, O(top_k * log(число списков)). При равенстве раньше идёт документ
+// списка с меньшим номером
+std::vector<Document> MergeTopDocuments(const std::vector<std::vector<Document>>& sorted_lists, size_t top_k);